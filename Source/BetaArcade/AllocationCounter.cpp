@@ -0,0 +1,187 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AllocationCounter.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformAtomics.h"
+#include "HAL/PlatformTLS.h"
+#include "Templates/TypeCompatibleBytes.h"
+#include "CoreGlobals.h"
+
+namespace
+{
+	class FCountingMalloc : public FMalloc
+	{
+	public:
+
+		FMalloc* inner = nullptr;
+		volatile int64 allocationCount = 0;
+		volatile int64 allocatedBytes = 0;
+
+		// Only touched from the game thread, no atomics needed
+		int64 gameThreadAllocationCount = 0;
+		FAllocationRegionStats regions[MAX_ALLOCATION_REGIONS];
+		int32 numRegions = 1;
+		int32 currentRegion = 0;
+
+		void Count(SIZE_T size)
+		{
+			FPlatformAtomics::InterlockedIncrement(&allocationCount);
+			FPlatformAtomics::InterlockedAdd(&allocatedBytes, (int64)size);
+
+			if (FPlatformTLS::GetCurrentThreadId() == GGameThreadId)
+			{
+				gameThreadAllocationCount++;
+				regions[currentRegion].allocations++;
+				regions[currentRegion].bytes += size;
+			}
+		}
+
+		virtual void* Malloc(SIZE_T count, uint32 alignment) override
+		{
+			Count(count);
+			return inner->Malloc(count, alignment);
+		}
+
+		virtual void* TryMalloc(SIZE_T count, uint32 alignment) override
+		{
+			Count(count);
+			return inner->TryMalloc(count, alignment);
+		}
+
+		virtual void* Realloc(void* original, SIZE_T count, uint32 alignment) override
+		{
+			if (!original || count > 0)
+			{
+				Count(count);
+			}
+			return inner->Realloc(original, count, alignment);
+		}
+
+		virtual void* TryRealloc(void* original, SIZE_T count, uint32 alignment) override
+		{
+			if (!original || count > 0)
+			{
+				Count(count);
+			}
+			return inner->TryRealloc(original, count, alignment);
+		}
+
+		virtual void Free(void* original) override { inner->Free(original); }
+		virtual SIZE_T QuantizeSize(SIZE_T count, uint32 alignment) override { return inner->QuantizeSize(count, alignment); }
+		virtual bool GetAllocationSize(void* original, SIZE_T& sizeOut) override { return inner->GetAllocationSize(original, sizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual bool IsInternallyThreadSafe() const override { return inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return inner->ValidateHeap(); }
+		virtual void UpdateStats() override { inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& outStats) override { inner->GetAllocatorStats(outStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& ar) override { inner->DumpAllocatorStats(ar); }
+		virtual const TCHAR* GetDescriptiveName() override { return inner->GetDescriptiveName(); }
+	};
+
+	// Built in static storage and never destroyed, other threads can still be inside it after Uninstall,
+	// and GMalloc can still point at it while statics are torn down at exit
+	TTypeCompatibleBytes<FCountingMalloc> countingMallocStorage;
+	FCountingMalloc& countingMalloc = *new (countingMallocStorage.GetTypedPtr()) FCountingMalloc();
+}
+
+void FAllocationCounter::Install()
+{
+	if (!IsInstalled())
+	{
+		countingMalloc.inner = GMalloc;
+		FPlatformAtomics::InterlockedExchange(&countingMalloc.allocationCount, 0);
+		FPlatformAtomics::InterlockedExchange(&countingMalloc.allocatedBytes, 0);
+		countingMalloc.gameThreadAllocationCount = 0;
+		ResetRegions();
+		FPlatformMisc::MemoryBarrier();
+		GMalloc = &countingMalloc;
+	}
+}
+
+void FAllocationCounter::Uninstall()
+{
+	if (IsInstalled())
+	{
+		GMalloc = countingMalloc.inner;
+	}
+}
+
+bool FAllocationCounter::IsInstalled()
+{
+	return GMalloc == &countingMalloc;
+}
+
+int64 FAllocationCounter::GetAllocationCount()
+{
+	return FPlatformAtomics::AtomicRead(&countingMalloc.allocationCount);
+}
+
+int64 FAllocationCounter::GetAllocatedBytes()
+{
+	return FPlatformAtomics::AtomicRead(&countingMalloc.allocatedBytes);
+}
+
+int64 FAllocationCounter::GetGameThreadAllocationCount()
+{
+	return countingMalloc.gameThreadAllocationCount;
+}
+
+int32 FAllocationCounter::RegisterRegion(const TCHAR* name)
+{
+	countingMalloc.regions[0].name = TEXT("Untracked");
+
+	for (int32 region = 1; region < countingMalloc.numRegions; ++region)
+	{
+		if (FCString::Strcmp(countingMalloc.regions[region].name, name) == 0)
+		{
+			return region;
+		}
+	}
+
+	if (countingMalloc.numRegions >= MAX_ALLOCATION_REGIONS)
+	{
+		return 0;
+	}
+
+	countingMalloc.regions[countingMalloc.numRegions].name = name;
+	return countingMalloc.numRegions++;
+}
+
+int32 FAllocationCounter::GetNumRegions()
+{
+	return countingMalloc.numRegions;
+}
+
+const FAllocationRegionStats& FAllocationCounter::GetRegion(int32 region)
+{
+	return countingMalloc.regions[FMath::Clamp(region, 0, countingMalloc.numRegions - 1)];
+}
+
+void FAllocationCounter::ResetRegions()
+{
+	for (FAllocationRegionStats& region : countingMalloc.regions)
+	{
+		region.allocations = 0;
+		region.bytes = 0;
+	}
+}
+
+FAllocationCounter::FScope::FScope(int32 region)
+	: previousRegion(countingMalloc.currentRegion)
+{
+	// Other threads don't move the game thread's region
+	if (FPlatformTLS::GetCurrentThreadId() == GGameThreadId)
+	{
+		countingMalloc.currentRegion = region;
+	}
+}
+
+FAllocationCounter::FScope::~FScope()
+{
+	if (FPlatformTLS::GetCurrentThreadId() == GGameThreadId)
+	{
+		countingMalloc.currentRegion = previousRegion;
+	}
+}
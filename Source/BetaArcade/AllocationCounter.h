@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+static const int MAX_ALLOCATION_REGIONS = 32;
+
+// Game thread allocations made inside one BETAARCADE_ALLOCATION_SCOPE, region 0 is everything outside a scope
+struct FAllocationRegionStats
+{
+	const TCHAR* name = nullptr;
+	int64 allocations = 0;
+	int64 bytes = 0;
+};
+
+/**
+ * Wraps GMalloc with a forwarding allocator that counts heap allocations.
+ * Only meant for benchmarks and diagnostics - install it, run the code being measured, read the count.
+ *
+ * Game thread allocations are also counted on their own and charged to the innermost
+ * BETAARCADE_ALLOCATION_SCOPE, so the BetaArcade.AllocCheck test can say which part of a frame allocated.
+ */
+class BETAARCADE_API FAllocationCounter
+{
+public:
+
+	static void Install();
+	static void Uninstall();
+	static bool IsInstalled();
+
+	// Allocations (Malloc and Realloc that allocate) since Install
+	static int64 GetAllocationCount();
+	static int64 GetAllocatedBytes();
+
+	// The same, only counting the game thread
+	static int64 GetGameThreadAllocationCount();
+
+	// Game thread only, names must be string literals. Returns 0 once every region is taken
+	static int32 RegisterRegion(const TCHAR* name);
+	static int32 GetNumRegions();
+	static const FAllocationRegionStats& GetRegion(int32 region);
+	static void ResetRegions();
+
+	class BETAARCADE_API FScope
+	{
+	public:
+
+		FScope(int32 region);
+		~FScope();
+
+	private:
+
+		int32 previousRegion;
+	};
+};
+
+// Charges game thread allocations until the end of the block to the named region
+#if !UE_BUILD_SHIPPING
+#define BETAARCADE_ALLOCATION_SCOPE(Name) \
+	static const int32 PREPROCESSOR_JOIN(allocationRegion, __LINE__) = FAllocationCounter::RegisterRegion(TEXT(Name)); \
+	FAllocationCounter::FScope PREPROCESSOR_JOIN(allocationScope, __LINE__)(PREPROCESSOR_JOIN(allocationRegion, __LINE__))
+#else
+#define BETAARCADE_ALLOCATION_SCOPE(Name)
+#endif
@@ -1,7 +1,35 @@
 // Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
 
 #include "BetaArcade.h"
+#include "AllocationCounter.h"
+#include "BetaArcadeBenchmark.h"
+#include "BetaArcadeMemory.h"
+#include "BlueprintEventProfiler.h"
 #include "Modules/ModuleManager.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, BetaArcade, "BetaArcade" );
- 
\ No newline at end of file
+class FBetaArcadeModule : public FDefaultGameModuleImpl
+{
+public:
+
+	virtual void StartupModule() override
+	{
+		RegisterBetaArcadeLLMTags();
+#if !UE_BUILD_SHIPPING
+		FBlueprintEventProfiler::Startup();
+#endif
+	}
+
+	virtual void ShutdownModule() override
+	{
+		FTwoPhaseBenchmark::Shutdown();
+#if !UE_BUILD_SHIPPING
+		FBlueprintEventProfiler::Shutdown();
+#endif
+		// Hand GMalloc back while the module's code is still loaded
+		FAllocationCounter::Uninstall();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FBetaArcadeModule, BetaArcade, "BetaArcade" );
+
+DEFINE_LOG_CATEGORY(LogBetaArcade);
@@ -3,3 +3,8 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogBetaArcade, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("BetaArcade"), STATGROUP_BetaArcade, STATCAT_Advanced);
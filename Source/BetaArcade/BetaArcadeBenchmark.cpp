@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BetaArcadeBenchmark.h"
+#include "BetaArcade.h"
+#include "Containers/Ticker.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "RenderCore.h"
+
+namespace
+{
+	TUniquePtr<FTwoPhaseBenchmark> activeBenchmark;
+	FDelegateHandle releaseHandle;
+}
+
+bool AppendBenchmarkCsv(const TCHAR* fileName, const TCHAR* header, const FString& rows)
+{
+	const FString outputPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / fileName;
+	FString csv;
+	if (!FPaths::FileExists(outputPath))
+	{
+		csv += header;
+		csv += TEXT("\n");
+	}
+	csv += rows;
+
+	if (!FFileHelper::SaveStringToFile(csv, *outputPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append))
+	{
+		UE_LOG(LogBetaArcade, Warning, TEXT("Could not write %s"), *outputPath);
+		return false;
+	}
+	return true;
+}
+
+FTwoPhaseBenchmark::FTwoPhaseBenchmark(const TCHAR* inName, UWorld* inWorld, int inFrames)
+	: name(inName), frames(FMath::Max(inFrames, 1)), world(inWorld)
+{
+}
+
+bool FTwoPhaseBenchmark::IsRunning()
+{
+	if (activeBenchmark && !activeBenchmark->finished)
+	{
+		UE_LOG(LogBetaArcade, Warning, TEXT("%s is already running"), activeBenchmark->name);
+		return true;
+	}
+	return false;
+}
+
+void FTwoPhaseBenchmark::Start(TUniquePtr<FTwoPhaseBenchmark> benchmark)
+{
+	if (!benchmark || IsRunning())
+	{
+		return;
+	}
+
+	activeBenchmark = MoveTemp(benchmark);
+	activeBenchmark->BeginPhase(0);
+}
+
+void FTwoPhaseBenchmark::Shutdown()
+{
+	// Before the engine's tickable list goes, rather than in static teardown
+	FTicker::GetCoreTicker().RemoveTicker(releaseHandle);
+	activeBenchmark.Reset();
+}
+
+void FTwoPhaseBenchmark::Tick(float DeltaTime)
+{
+	if (finished)
+	{
+		return;
+	}
+
+	if (!world.IsValid())
+	{
+		UE_LOG(LogBetaArcade, Warning, TEXT("%s stopped, the world went away"), name);
+		Restore();
+		Release();
+		return;
+	}
+
+	if (++frameInPhase > WARMUP_FRAMES)
+	{
+		gameThreadMs[phase] += FPlatformTime::ToMilliseconds(GGameThreadTime);
+		SampleFrame(phase);
+	}
+
+	if (frameInPhase >= frames + WARMUP_FRAMES)
+	{
+		phase++;
+		frameInPhase = 0;
+		if (phase == 1)
+		{
+			BeginPhase(1);
+		}
+		else
+		{
+			Restore();
+			Finish();
+			Release();
+		}
+	}
+}
+
+TStatId FTwoPhaseBenchmark::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FTwoPhaseBenchmark, STATGROUP_Tickables);
+}
+
+void FTwoPhaseBenchmark::Release()
+{
+	// Deleted next frame, not from inside its own Tick
+	finished = true;
+	releaseHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&FTwoPhaseBenchmark::ReleaseFinished));
+}
+
+bool FTwoPhaseBenchmark::ReleaseFinished(float DeltaTime)
+{
+	if (activeBenchmark && activeBenchmark->finished)
+	{
+		activeBenchmark.Reset();
+	}
+	return false;
+}
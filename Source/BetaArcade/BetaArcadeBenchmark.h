@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class UWorld;
+
+// Appends rows to Saved/Benchmarks/fileName, with the header line first if the file is new. Rows end in \n
+BETAARCADE_API bool AppendBenchmarkCsv(const TCHAR* fileName, const TCHAR* header, const FString& rows);
+
+/**
+ * Runs a live session for a number of frames with a baseline setup, then the same number with the change being
+ * measured, and sums the game thread time of each phase. One runs at a time, it is released once it has reported
+ * or its world has gone, and on module shutdown at the latest.
+ */
+class BETAARCADE_API FTwoPhaseBenchmark : public FTickableGameObject
+{
+public:
+
+	virtual ~FTwoPhaseBenchmark() {}
+
+	static bool IsRunning();
+
+	// Takes the benchmark over and starts its baseline phase, check IsRunning before building one
+	static void Start(TUniquePtr<FTwoPhaseBenchmark> benchmark);
+
+	static void Shutdown();
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool IsTickable() const override { return !finished; }
+
+protected:
+
+	FTwoPhaseBenchmark(const TCHAR* inName, UWorld* inWorld, int inFrames);
+
+	// Phase 0 is the baseline, phase 1 the change being measured
+	virtual void BeginPhase(int phase) = 0;
+
+	// Each frame of a phase once it has settled, the game thread time is already added up
+	virtual void SampleFrame(int phase) {}
+
+	// Puts the session back how it was, also when the benchmark is cut short
+	virtual void Restore() {}
+
+	// Both phases are done, report them
+	virtual void Finish() = 0;
+
+	UWorld* GetWorld() const { return world.Get(); }
+
+	const TCHAR* name;
+	int frames = 0;
+	double gameThreadMs[2] = { 0.0, 0.0 };
+
+private:
+
+	void Release();
+	static bool ReleaseFinished(float DeltaTime);
+
+	// GGameThreadTime is last frame's, skip a couple after switching phase
+	static const int WARMUP_FRAMES = 2;
+
+	TWeakObjectPtr<UWorld> world;
+	int frameInPhase = 0;
+	int phase = 0;
+	bool finished = false;
+};
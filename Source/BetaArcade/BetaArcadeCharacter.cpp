@@ -10,11 +10,30 @@
 #include "TimerManager.h"
 #include "PickUps+Hotbar/PickUpBase.h"
 #include "PickUps+Hotbar/HotbarComp.h"
+#include "BetaArcadeGameMode.h"
+#include "BetaArcadeTrace.h"
+#include "BlueprintEventProfiler.h"
+#include "RunnerMovementComponent.h"
+#include "EffectPoolSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Player Simulation Step"), STAT_PlayerSimulationStep, STATGROUP_BetaArcade);
+DECLARE_CYCLE_STAT(TEXT("Player Handle State"), STAT_PlayerHandleState, STATGROUP_BetaArcade);
+DECLARE_CYCLE_STAT(TEXT("Player AnimationState (BP)"), STAT_PlayerAnimationState, STATGROUP_BetaArcade);
+DECLARE_CYCLE_STAT(TEXT("Player Sort PickUp"), STAT_PlayerSortPickUp, STATGROUP_BetaArcade);
+DECLARE_CYCLE_STAT(TEXT("Player Combat"), STAT_PlayerCombat, STATGROUP_BetaArcade);
+
+#if !UE_BUILD_SHIPPING
+static TAutoConsoleVariable<int32> CVarBlueprintEventsLogOnEndPlay(
+	TEXT("BetaArcade.BlueprintEventsLogOnEndPlay"),
+	1,
+	TEXT("1 logs the Blueprint event breakdown and appends it to Saved/Benchmarks/BlueprintEvents.csv when the player's run ends"));
+#endif
 
 //////////////////////////////////////////////////////////////////////////
 // ABetaArcadeCharacter
 
-ABetaArcadeCharacter::ABetaArcadeCharacter()
+ABetaArcadeCharacter::ABetaArcadeCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<URunnerMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
@@ -37,6 +56,7 @@ ABetaArcadeCharacter::ABetaArcadeCharacter()
 	characterState = CharacterState::State::None;
 
 	playerMovement = GetCharacterMovement();
+	runnerMovement = Cast<URunnerMovementComponent>(playerMovement);
 	currentCamRotation = { -10,0,0 };
 	currentCamPosition = CameraBoom->GetComponentLocation();
 	currentMonsterRotation = { 0,0,0 };
@@ -72,10 +92,115 @@ void ABetaArcadeCharacter::SetupPlayerInputComponent(class UInputComponent* Play
 
 void ABetaArcadeCharacter::Tick(float DeltaTime)
 {
+	BETAARCADE_ALLOCATION_SCOPE("PlayerTick");
+
 	Super::Tick(DeltaTime);
+
+	// The frame only decides how many steps are due, gameplay itself always moves in whole steps
+	const int steps = simulationClock.Advance(DeltaTime);
+	for (int i = 0; i < steps; ++i)
+	{
+		previousSimState = simState;
+		SimulationStep(simulationClock.GetStepSeconds());
+	}
+
+	PresentSimulation(simulationClock.GetAlpha());
+}
+
+void ABetaArcadeCharacter::SimulationStep(float StepSeconds)
+{
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_PlayerSimulationStep);
+	BETAARCADE_ALLOCATION_SCOPE("PlayerSimulation");
+
 	AddPointsToScore(1 * scoreMultiplier);
 
-	HandleState();
+	ABetaArcadeGameMode* gameMode = GetWorld()->GetAuthGameMode<ABetaArcadeGameMode>();
+	if (gameMode)
+	{
+		simState.distance += gameMode->GetMapVelocity().Size() * StepSeconds;
+	}
+
+	if (monster && playerLives > 0)
+	{
+		simState.monsterGap = FMath::FInterpConstantTo(simState.monsterGap, monster->GetGapForLives(playerLives), StepSeconds, monsterGapSpeed);
+	}
+
+	TickPowerUpTimers(StepSeconds);
+
+	// Runs per step rather than per frame, so HandleState, AnimationState and the Combat event fire 0, 1 or
+	// (after a slow frame) several times in one rendered frame - Blueprints must not count on one call a frame
+	HandleState(StepSeconds);
+}
+
+void ABetaArcadeCharacter::PresentSimulation(float alpha)
+{
+	const FRunnerSimState presented = FRunnerSimState::Lerp(previousSimState, simState, alpha);
+
+	// Once the lives run out the monster stays where the last step left it
+	if (monster && playerLives > 0)
+	{
+		monster->SetGap(presented.monsterGap, GetActorLocation().X);
+	}
+}
+
+void ABetaArcadeCharacter::StartPowerUpTimer(TEnumAsByte<PowerState::State> powerState, float duration)
+{
+	if (duration <= 0.0f)
+	{
+		return;
+	}
+
+	// Picking the same power up again restarts it
+	for (FPowerUpTimer& timer : powerUpTimers)
+	{
+		if (timer.powerState == powerState)
+		{
+			timer.timeLeft = duration;
+			return;
+		}
+	}
+
+	FPowerUpTimer timer;
+	timer.powerState = powerState;
+	timer.timeLeft = duration;
+	powerUpTimers.Add(timer);
+}
+
+void ABetaArcadeCharacter::TickPowerUpTimers(float StepSeconds)
+{
+	for (int i = powerUpTimers.Num() - 1; i >= 0; --i)
+	{
+		powerUpTimers[i].timeLeft -= StepSeconds;
+		if (powerUpTimers[i].timeLeft > 0.0f)
+		{
+			continue;
+		}
+
+		const PowerState::State powerState = powerUpTimers[i].powerState;
+		powerUpTimers.RemoveAtSwap(i, 1, false);
+
+		switch (powerState)
+		{
+		case PowerState::State::SpeedBoost:
+			ResetPlayerSpeed();
+			scoreMultiplier = 1;
+			break;
+		case PowerState::State::ScoreBonus:
+			scoreMultiplier = 1;
+			break;
+		case PowerState::State::Magnet:
+			isMagnetActive = false;
+			break;
+		default:
+			break;
+		}
+
+		if (currentPowerState == powerState)
+		{
+			currentPowerState = lightCapacity >= MAX_LIGHT_CAPACITY ? PowerState::State::FullLight : PowerState::State::None;
+		}
+		BETAARCADE_BLUEPRINT_EVENT(PowerUpExpired, PowerUpExpired(powerState));
+	}
 }
 
 //BETH - 
@@ -83,6 +208,13 @@ void ABetaArcadeCharacter::Tick(float DeltaTime)
 //Sort Pick Ups into instant use or hotbar.
 void ABetaArcadeCharacter::SortPickUp(class APickUpBase* PickUp)
 {
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_PlayerSortPickUp);
+
+	if (PickUp)
+	{
+		FBetaArcadeTrace::PickUpCollected(PickUp->PickUpID);
+	}
+
 	if (PickUp->PickUpID <= 3 && PickUp != NULL)
 	{
 		
@@ -129,59 +261,141 @@ bool ABetaArcadeCharacter::LightMetreFull()
 }
 
 // FRAN - State control
-void ABetaArcadeCharacter::HandleState()
+void ABetaArcadeCharacter::HandleState(float StepSeconds)
 {
-	if ((LightMetreFull()) && (!lightWidgetActive))
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_PlayerHandleState);
+	BETAARCADE_ALLOCATION_SCOPE("HandleState");
+
+	// Only looks at the meter until the widget is up, so the power state isn't rewritten every step
+	if ((!lightWidgetActive) && (LightMetreFull()))
 	{
-		LightWidgetOn();
+		BETAARCADE_BLUEPRINT_EVENT(LightWidgetOn, LightWidgetOn());
 		lightWidgetActive = true;
 	}
 
+	// Blueprints still set characterState directly, run the transition they skipped
+	if (characterState != enteredState)
+	{
+		SetCharacterState(characterState);
+	}
+
 	switch (characterState)
 	{
-	case CharacterState::State::None:
+	case CharacterState::State::Vaulting:
+		if ((stateTimeLeft > 0.0f) && ((stateTimeLeft -= StepSeconds) <= 0.0f))
+		{
+			StopVaulting();
+		}
+		break;
+
+	case CharacterState::State::Sliding:
+		if ((stateTimeLeft > 0.0f) && ((stateTimeLeft -= StepSeconds) <= 0.0f))
+		{
+			StopSliding();
+		}
+		break;
+
+	case CharacterState::State::Combat:
+	{
+		BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_PlayerCombat);
+		BETAARCADE_BLUEPRINT_EVENT(Combat, Combat());
+		break;
+	}
+
+	default: // None, Jumping and Swarm wait for an event
 		break;
+	}
+}
+
+void ABetaArcadeCharacter::SetCharacterState(TEnumAsByte<CharacterState::State> newState)
+{
+	characterState = newState;
+	if (newState == enteredState)
+	{
+		return;
+	}
+
+	ExitState(enteredState);
+	enteredState = newState;
+	EnterState(newState);
+
+	// The Blueprint side of the state machine, usually the most expensive part, so only on a change
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_PlayerAnimationState);
+	BETAARCADE_ALLOCATION_SCOPE("AnimationState");
+	BETAARCADE_BLUEPRINT_EVENT(AnimationState, AnimationState());
+}
 
+void ABetaArcadeCharacter::EnterState(CharacterState::State state)
+{
+	switch (state)
+	{
 	case CharacterState::State::Jumping:
-		JumpEndCheck();
+		isJumping = true;
 		break;
 
 	case CharacterState::State::Vaulting:
+		stateTimeLeft = vaultTime;
 		break;
 
 	case CharacterState::State::Sliding:
+		stateTimeLeft = slideTime;
 		break;
 
-	case CharacterState::State::Combat:
-		Combat();
+	default:
 		break;
+	}
+}
 
-	case CharacterState::State::Swarm:
+void ABetaArcadeCharacter::ExitState(CharacterState::State state)
+{
+	switch (state)
+	{
+	case CharacterState::State::Jumping:
+		isJumping = false;
+		break;
+
+	case CharacterState::State::Vaulting:
+		StopJumping();
+		stateTimeLeft = 0.0f;
+		break;
+
+	case CharacterState::State::Sliding:
+		stateTimeLeft = 0.0f;
 		break;
 
 	default:
 		break;
 	}
+}
 
-	AnimationState();
+void ABetaArcadeCharacter::Landed(const FHitResult& Hit)
+{
+	Super::Landed(Hit);
+
+	if (enteredState == CharacterState::State::Jumping)
+	{
+		SetCharacterState(CharacterState::State::None);
+	}
 }
 
 void ABetaArcadeCharacter::EnterCombat()
 {
 	if ((!inCombat) && (LightMetreFull())) // not currently in combat
 	{
-		LightWidgetOff();
+		BETAARCADE_BLUEPRINT_EVENT(LightWidgetOff, LightWidgetOff());
 
 		bonusChance = 0;
 		currentCamRotation = cameraFlipRotation;
 		currentCamPosition = camZoomPos;
-		PlayCombatSound();
+		BETAARCADE_BLUEPRINT_EVENT(PlayCombatSound, PlayCombatSound());
 
 		combatActive = true;
-		characterState = CharacterState::State::Combat;
+		SetCharacterState(CharacterState::State::Combat);
 
-		CameraFlip();
+		BETAARCADE_BLUEPRINT_EVENT(CameraFlip, CameraFlip());
 		inCombat = !inCombat;
+		FBetaArcadeTrace::CombatChanged(true);
+		PlayEffect(ERunnerEffect::eCombatStart);
 	}
 }
 
@@ -189,7 +403,7 @@ void ABetaArcadeCharacter::EndCombat()
 {
 	if (inCombat)
 	{
-		PlayCombatSound();
+		BETAARCADE_BLUEPRINT_EVENT(PlayCombatSound, PlayCombatSound());
 		inCombat = !inCombat;
 		GiveBonus();
 		currentCamRotation = initialCamRot;
@@ -198,8 +412,18 @@ void ABetaArcadeCharacter::EndCombat()
 		combatActive = false;
 		bonusChance = 0;
 
-		CameraFlip();
-		characterState = CharacterState::State::None;
+		BETAARCADE_BLUEPRINT_EVENT(CameraFlip, CameraFlip());
+		SetCharacterState(CharacterState::State::None);
+		FBetaArcadeTrace::CombatChanged(false);
+		PlayEffect(ERunnerEffect::eCombatEnd);
+	}
+}
+
+void ABetaArcadeCharacter::PlayEffect(ERunnerEffect effect)
+{
+	if (UEffectPoolSubsystem* effectPool = GetWorld()->GetSubsystem<UEffectPoolSubsystem>())
+	{
+		effectPool->PlayEffect(effect, FVector::ZeroVector, FRotator::ZeroRotator, GetRootComponent(), this);
 	}
 }
 
@@ -228,12 +452,11 @@ void ABetaArcadeCharacter::BetaJump()
 	{
 		if (canVault)
 		{
-			VaultControl();
+			BETAARCADE_BLUEPRINT_EVENT(VaultControl, VaultControl());
 		}
 		else if ((characterState == CharacterState::None) && (canMove))
 		{
-			isJumping = true;
-			characterState = CharacterState::State::Jumping;
+			SetCharacterState(CharacterState::State::Jumping);
 			Jump();
 		}
 	}
@@ -243,14 +466,6 @@ void ABetaArcadeCharacter::BetaJump()
 	}
 }
 
-void ABetaArcadeCharacter::JumpEndCheck()
-{
-	if (!isJumping) // set on hit floor
-	{
-		characterState = CharacterState::State::None;
-	}
-}
-
 void ABetaArcadeCharacter::BetaJumpStop() // UE4 func - called in Jump()
 {
 	StopJumping();
@@ -260,7 +475,7 @@ bool ABetaArcadeCharacter::StartSlide()
 {
 	if (characterState == CharacterState::State::None)
 	{
-		characterState = CharacterState::State::Sliding;
+		SetCharacterState(CharacterState::State::Sliding);
 		return true;
 	}
 
@@ -269,14 +484,14 @@ bool ABetaArcadeCharacter::StartSlide()
 
 void ABetaArcadeCharacter::StopSliding()
 {
-	characterState = CharacterState::State::None;
+	SetCharacterState(CharacterState::State::None);
 }
 
 bool ABetaArcadeCharacter::StartVault()
 {
 	if (characterState == CharacterState::State::None)
 	{
-		characterState = CharacterState::State::Vaulting;
+		SetCharacterState(CharacterState::State::Vaulting);
 		Jump();
 
 		return true;
@@ -287,8 +502,7 @@ bool ABetaArcadeCharacter::StartVault()
 
 void ABetaArcadeCharacter::StopVaulting()
 {
-	StopJumping();
-	characterState = CharacterState::State::None;
+	SetCharacterState(CharacterState::State::None); // Exiting the vault stops the jump
 }
 
 void ABetaArcadeCharacter::DodgeCheck(FKey playerKeyPressed)
@@ -323,46 +537,14 @@ void ABetaArcadeCharacter::MoveForward(float Value)
 
 void ABetaArcadeCharacter::MoveRight(float Value)
 {
-	FRotator Left = { 0,-50,0 };
-	FRotator Right = { 0,50,0 };
+	BETAARCADE_ALLOCATION_SCOPE("MoveRight");
 
-	FVector leftMove = { 0,-14,0 };
-	FVector rightMove = { 0,14,0 };
+	// The movement component does the lane change and the lean as part of its own move
+	const bool canChangeLane = (canMove) && (Controller != NULL)
+		&& ((characterState == CharacterState::State::None) || (characterState == CharacterState::State::Swarm));
+	runnerMovement->SetLaneInput(canChangeLane ? Value : 0.0f, currentPlayerRotation);
 
-	if (((characterState == CharacterState::State::None) && (canMove)) || ((characterState == CharacterState::State::Swarm) && (canMove)))
-	{
-		if ((Controller != NULL) && (Value != 0.0f))
-		{
-			FVector pos = GetActorLocation();
-			if (Value < 0) // A
-			{
-				if (GetActorLocation().Y >= -240)
-				{
-					Left += currentPlayerRotation;
-					leftMove += pos;
-					SetActorRotation(FMath::Lerp(GetActorRotation(), Left, 0.6f));
-					SetActorLocation(leftMove, false, 0, ETeleportType::None);
-				}
-			}
-			else if (Value > 0)
-			{
-				if (GetActorLocation().Y <= 240)
-				{
-					Right += currentPlayerRotation;
-					rightMove += pos;
-					SetActorRotation(FMath::Lerp(GetActorRotation(), Right, 0.6f));
-					SetActorLocation(rightMove, false, 0, ETeleportType::None);
-				}
-			}
-			Direction = GetActorForwardVector();
-		}
-
-		if (Value == 0)
-		{
-			SetActorRotation(FMath::Lerp(GetActorRotation(), currentPlayerRotation, 0.5f));
-			Direction = GetActorForwardVector();
-		}
-	}
+	Direction = GetActorForwardVector();
 }
 
 // Called when the game starts or when spawned
@@ -370,7 +552,8 @@ void ABetaArcadeCharacter::BeginPlay()
 {
 	Super::BeginPlay();
 
-	GetMapSpeed(); // Stores starting speed
+	FBlueprintEventProfiler::ResetRun();
+	BETAARCADE_BLUEPRINT_EVENT(GetMapSpeed, GetMapSpeed()); // Stores starting speed
 	initialPos = GetActorLocation();
 
 	initialCamPos = CameraBoom->GetRelativeLocation();
@@ -378,4 +561,38 @@ void ABetaArcadeCharacter::BeginPlay()
 
 	currentCamRotation = initialCamRot;
 	currentCamPosition = initialCamPos;
-}
\ No newline at end of file
+
+	simulationClock.SetRate(simulationRate);
+	if (monster)
+	{
+		monster->SetGapDrivenBySimulation(true);
+		simState.monsterGap = monster->GetGapForLives(playerLives);
+	}
+	previousSimState = simState;
+}
+
+void ABetaArcadeCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+#if !UE_BUILD_SHIPPING
+	if (CVarBlueprintEventsLogOnEndPlay.GetValueOnGameThread() != 0)
+	{
+		FBlueprintEventProfiler::LogRun();
+	}
+#endif
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ABetaArcadeCharacter::AddPlayerLives(int lives)
+{
+	if ((playerLives + lives) <= MAX_PLAYER_LIVES)
+	{
+		playerLives += lives;
+		BETAARCADE_BLUEPRINT_EVENT(LivesEvent, LivesEvent());
+	}
+}
+
+void ABetaArcadeCharacter::ResetPlayerSpeed()
+{
+	BETAARCADE_BLUEPRINT_EVENT(SetPlayerSpeed, SetPlayerSpeed(initialMapSpeed));
+}
@@ -6,6 +6,8 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/Character.h"
 #include "Monster.h"
+#include "RunnerSimulation.h"
+#include "EffectPoolSubsystem.h"
 #include "BetaArcadeCharacter.generated.h"
 
 UENUM(BlueprintType)
@@ -44,6 +46,9 @@ class ABetaArcadeCharacter : public ACharacter
 {
 	GENERATED_BODY()
 
+	// The autoplay bot presses the same inputs a player would
+	friend class APlayerCharacterState;
+
 		/** Camera boom positioning the camera behind the character */
 		UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Camera, meta = (AllowPrivateAccess = "true"))
 		class USpringArmComponent* CameraBoom;
@@ -53,7 +58,7 @@ class ABetaArcadeCharacter : public ACharacter
 		class UCameraComponent* PlayerCamera;
 
 public:
-	ABetaArcadeCharacter();	
+	ABetaArcadeCharacter(const FObjectInitializer& ObjectInitializer);
 
 	UPROPERTY(BlueprintReadOnly)
 		FVector playerDirection = { 0,0,0 };
@@ -110,6 +115,8 @@ protected:
 
 	UPROPERTY()
 		UCharacterMovementComponent* playerMovement;
+	UPROPERTY()
+		class URunnerMovementComponent* runnerMovement;
 	UPROPERTY(BlueprintReadWrite)
 		float initialMapSpeed = 0.0f;
 
@@ -159,15 +166,54 @@ protected:
 	UPROPERTY(BlueprintReadWrite)
 	int bonusChance = 0;
 
+	// Fixed step simulation - score, distance, state, monster gap and power up timers advance in steps
+	// of 1 / simulationRate, so a run plays out the same at 30 and 144 fps
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Simulation)
+		float simulationRate = 60.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Simulation)
+		float monsterGapSpeed = 1500.0f; // How fast the monster closes in or drops back when lives change
+
+	// Power ups end on their own after these many seconds, 0 leaves it to the Blueprint
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Simulation)
+		float speedBoostDuration = 0.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Simulation)
+		float scoreBonusDuration = 0.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Simulation)
+		float magnetDuration = 0.0f;
+
+	// The state the machine last entered, differs from characterState for a step when the Blueprint sets it directly
+	CharacterState::State enteredState = CharacterState::State::None;
+	float stateTimeLeft = 0.0f; // Slides and vaults end on their own after slideTime and vaultTime, 0 leaves it to the Blueprint
+
+	FFixedStepClock simulationClock;
+	FRunnerSimState previousSimState;
+	FRunnerSimState simState;
+
+	struct FPowerUpTimer
+	{
+		PowerState::State powerState;
+		float timeLeft;
+	};
+	TArray<FPowerUpTimer, TInlineAllocator<4>> powerUpTimers;
+
+	void SimulationStep(float StepSeconds);
+	void PresentSimulation(float alpha);
+	void TickPowerUpTimers(float StepSeconds);
+
+	UFUNCTION(BlueprintImplementableEvent)
+		void PowerUpExpired(TEnumAsByte<PowerState::State> powerState);
+
 protected:
 	// APawn interface
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 	// End of APawn interface
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
-	// State control
-	void HandleState();
+	void EnterState(CharacterState::State state);
+	void ExitState(CharacterState::State state);
+	virtual void Landed(const FHitResult& Hit) override;
 	UFUNCTION(BlueprintCallable)
 		void EnterCombat();
 	UFUNCTION(BlueprintCallable)
@@ -178,13 +224,11 @@ protected:
 		void PlayCombatSound();
 	void CombatBonus();
 	void GiveBonus();
+	void PlayEffect(ERunnerEffect effect); // Attached to the player
 
 	void BetaJump();
-	void JumpEndCheck();
 	void BetaJumpStop();
 
-	UFUNCTION(BlueprintCallable)
-		bool StartSlide();
 	void Slide();
 	UFUNCTION(BlueprintCallable)
 		void StopSliding();
@@ -213,15 +257,43 @@ protected:
 public:
 	virtual void Tick(float DeltaTime) override;
 
+	// State control - transitions run the exit and enter of the states involved, a step only does
+	// the work of the current state
+	void HandleState(float StepSeconds);
+	UFUNCTION(BlueprintCallable)
+		void SetCharacterState(TEnumAsByte<CharacterState::State> newState);
+	UFUNCTION(BlueprintCallable)
+		bool StartSlide();
+
 	//FRAN- PowerUp State
 	UPROPERTY(BlueprintReadWrite)
 		TEnumAsByte<PowerState::State> currentPowerState;
 
+	// Counts down in simulation steps, a duration of 0 or less does nothing
+	UFUNCTION(BlueprintCallable)
+		void StartPowerUpTimer(TEnumAsByte<PowerState::State> powerState, float duration);
+
+	float GetSpeedBoostDuration() const { return speedBoostDuration; }
+	float GetScoreBonusDuration() const { return scoreBonusDuration; }
+	float GetMagnetDuration() const { return magnetDuration; }
+
+	// Distance run, interpolated between the last two simulation steps
+	UFUNCTION(BlueprintCallable)
+		float GetSimulatedDistance() const { return FRunnerSimState::Lerp(previousSimState, simState, simulationClock.GetAlpha()).distance; }
+
+	uint64 GetSimulationStepCount() const { return simulationClock.GetStepCount(); }
+	double GetDroppedSimulationSeconds() const { return simulationClock.GetDroppedSeconds(); }
+
+	// Catch up steps allowed in one frame, 0 or less runs every step that is due
+	void SetMaxSimulationStepsPerFrame(int maxSteps) { simulationClock.maxStepsPerFrame = maxSteps; }
+
+	TEnumAsByte<CharacterState::State> GetCharacterState() const { return characterState; }
+
 	// LIVES
 	UFUNCTION(BlueprintCallable)
 		int GetPlayerLives() { return playerLives; };
 	UFUNCTION(BlueprintCallable)
-		void AddPlayerLives(int lives) { if ((playerLives + lives) <= MAX_PLAYER_LIVES) { playerLives += lives; LivesEvent(); } }; // Adds however many lives are passed in, to take away lives just pass in a negative
+		void AddPlayerLives(int lives); // Adds however many lives are passed in, to take away lives just pass in a negative
 
 	bool GetSwarmReaction() { return swarmReacting; };
 	UFUNCTION(BlueprintCallable)
@@ -229,7 +301,7 @@ public:
 
 	// SPEED
 	UFUNCTION(BlueprintCallable)
-		void ResetPlayerSpeed() { SetPlayerSpeed(initialMapSpeed); }; // Sets speed to original value
+		void ResetPlayerSpeed(); // Sets speed to original value
 	UFUNCTION(BlueprintImplementableEvent, BlueprintCallable)
 		void SetPlayerSpeed(float speed);
 
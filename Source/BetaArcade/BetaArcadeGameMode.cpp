@@ -1,10 +1,36 @@
 // Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
 
 #include "BetaArcadeGameMode.h"
-//#include "BetaArcadeCharacter.h"
+#include "BetaArcadeCharacter.h"
+#include "BetaArcade.h"
+#include "BetaArcadeTrace.h"
+#include "BetaArcadeMemory.h"
+#include "TilePoolSubsystem.h"
+#include "HitchMonitor.h"
+#include "TileAssetLoader.h"
+#include "TrackScrollerComponent.h"
+#include "TrackInstanceManager.h"
+#include "SpawnSchedulerComponent.h"
+#include "IslandManagerComponent.h"
+#include "PickUps+Hotbar/PickUpField.h"
+#include "PickUps+Hotbar/PickUpBase.h"
+#include "TrackSpatialIndex.h"
+#include "Kismet/GameplayStatics.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/GameInstance.h"
+#include "Engine/DataTable.h"
+#include "GameMapsSettings.h"
+#include "Misc/PackageName.h"
 #include "Math.h"
 #include "UObject/ConstructorHelpers.h"
 
+DECLARE_CYCLE_STAT(TEXT("Spawn Random Tile"), STAT_SpawnRandomTile, STATGROUP_BetaArcade);
+DECLARE_CYCLE_STAT(TEXT("Spawn Corner Tile"), STAT_SpawnCornerTile, STATGROUP_BetaArcade);
+DECLARE_CYCLE_STAT(TEXT("Spawn Start Tile"), STAT_SpawnStartTile, STATGROUP_BetaArcade);
+DECLARE_CYCLE_STAT(TEXT("Spawn Floating Island"), STAT_SpawnFloatingIsland, STATGROUP_BetaArcade);
+DECLARE_CYCLE_STAT(TEXT("Recycle Tile"), STAT_RecycleTile, STATGROUP_BetaArcade);
+DECLARE_CYCLE_STAT(TEXT("Game Mode Tick"), STAT_GameModeTick, STATGROUP_BetaArcade);
+
 ABetaArcadeGameMode::ABetaArcadeGameMode()
 {
 	// set default pawn class to our Blueprinted character
@@ -15,18 +41,369 @@ ABetaArcadeGameMode::ABetaArcadeGameMode()
 	}*/
 
 	spawnedTiles = 0;
+
+	PrimaryActorTick.bCanEverTick = true;
+	trackScroller = CreateDefaultSubobject<UTrackScrollerComponent>(TEXT("TrackScroller"));
+	spawnScheduler = CreateDefaultSubobject<USpawnSchedulerComponent>(TEXT("SpawnScheduler"));
+	islandManager = CreateDefaultSubobject<UIslandManagerComponent>(TEXT("IslandManager"));
 }
 
-AActor* ABetaArcadeGameMode::SpawnStartTile() // Spawn Start Tiles with no obstacles at start of Game
+void ABetaArcadeGameMode::BeginPlay()
 {
-	
-	UWorld* world = GetWorld();
-	if (world)
+	Super::BeginPlay();
+
+	isMenu |= IsMenuMap();
+	if (isMenu)
+	{
+		PreloadTileClasses();
+		return;
+	}
+
+	trackGenerator.Seed(FMath::Rand());
+	if (tileTransitionTable)
+	{
+		TArray<FTileTransitionRow*> rows;
+		tileTransitionTable->GetAllRows<FTileTransitionRow>(TEXT("TileTransitionTable"), rows);
+		trackGenerator.BuildTransitionTable(rows);
+	}
+	trackPlanner.Start(trackGenerator, tileLength);
+	UpdateLookaheadHorizon();
+
+	PreloadTileClasses(); // Prewarms the tile pools once the classes are in
+	currentTiles.Reserve(64);
+
+	if (UEffectPoolSubsystem* effectPool = GetWorld()->GetSubsystem<UEffectPoolSubsystem>())
+	{
+		for (const FRunnerEffectConfig& effect : effects)
+		{
+			effectPool->Configure(effect);
+		}
+	}
+
+	trackScroller->SetActive(useNativeScroller);
+	spawnScheduler->OnSpawnFinished.AddUObject(this, &ABetaArcadeGameMode::OnSpawnRequestFinished);
+	islandManager->mapDirection = mapDirection;
+	islandManager->OnRecycle.BindUObject(this, &ABetaArcadeGameMode::RecycleIsland);
+
+	if (instancedMeshes.Num() > 0)
+	{
+		if (useNativeScroller)
+		{
+			FActorSpawnParameters spawnParams;
+			spawnParams.Owner = this;
+
+			trackInstanceManager = GetWorld()->SpawnActor<ATrackInstanceManager>(spawnParams);
+			trackInstanceManager->instancedMeshes = instancedMeshes;
+			trackScroller->AddSegment(trackInstanceManager, true);
+		}
+		else
+		{
+			UE_LOG(LogBetaArcade, Warning, TEXT("instancedMeshes is set but useNativeScroller is off, tile meshes will not be instanced"));
+		}
+	}
+
+	if (pickUpFieldClass)
 	{
 		FActorSpawnParameters spawnParams;
 		spawnParams.Owner = this;
 
-		spawnedTile = world->SpawnActor<AActor>(basicTileClass, nextTileLocation, nextTileRotation, spawnParams);
+		pickUpField = GetWorld()->SpawnActor<APickUpField>(pickUpFieldClass, spawnParams);
+		pickUpField->mapDirection = mapDirection;
+		if (useNativeScroller)
+		{
+			trackScroller->AddSegment(pickUpField, true); // Orbs ride along with the track
+		}
+	}
+}
+
+void ABetaArcadeGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_GameModeTick);
+	BETAARCADE_ALLOCATION_SCOPE("GameModeTick");
+
+	trackScroller->scrollVelocity = GetMapVelocity();
+
+	// The player's fixed step simulation owns distance when there is one
+	ABetaArcadeCharacter* player = Cast<ABetaArcadeCharacter>(UGameplayStatics::GetPlayerPawn(this, 0));
+	trackDistanceTravelled = player ? player->GetSimulatedDistance() : trackDistanceTravelled + mapSpeed * DeltaSeconds;
+	if (UTrackSpatialIndex* trackIndex = GetWorld()->GetSubsystem<UTrackSpatialIndex>())
+	{
+		trackIndex->SetPlayerDistance(trackDistanceTravelled);
+	}
+}
+
+void ABetaArcadeGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	trackPlanner.Stop();
+	if (tileLoadHandle.IsValid())
+	{
+		tileLoadHandle->CancelHandle(); // Classes stay resident through the loader, only the prewarm callback goes
+		tileLoadHandle.Reset();
+	}
+	if (trackPlanner.GetUnderflows() > 0)
+	{
+		UE_LOG(LogBetaArcade, Warning, TEXT("Tile plan ran dry %d times, raise lookaheadSeconds"), trackPlanner.GetUnderflows());
+	}
+	UE_LOG(LogBetaArcade, Log, TEXT("Islands: %d live, %lld bytes, %d recycled"), islandManager->GetNumLiveIslands(), islandManager->GetLiveIslandBytes(), islandManager->islandsRecycled);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ABetaArcadeGameMode::PrewarmTilePools()
+{
+	UTilePoolSubsystem* pool = GetWorld() ? GetWorld()->GetSubsystem<UTilePoolSubsystem>() : NULL;
+	if (pool)
+	{
+		TSoftClassPtr<AActor> tileClasses[] = { basicTileClass, vaultTileClass, slideTileClass, jumpTileClass, swarmTileClass,
+			leftCliffTileClass, rightCliffTileClass, leftCornerTileClass, rightCornerTileClass };
+
+		// Only classes that are resident, anything that failed to load gets pooled on first use
+		{
+			BETAARCADE_LLM_SCOPE(Tiles);
+			for (const TSoftClassPtr<AActor>& tileClass : tileClasses)
+			{
+				pool->Prewarm(tileClass.Get(), tilePoolSize, this);
+			}
+		}
+
+		BETAARCADE_LLM_SCOPE(Islands);
+		pool->Prewarm(floatingIslandClass.Get(), islandPoolSize, this);
+		for (const TSoftClassPtr<AActor>& islandClass : floatingIslandVariants)
+		{
+			pool->Prewarm(islandClass.Get(), islandPoolSize, this);
+		}
+	}
+}
+
+void ABetaArcadeGameMode::UseStandInTileClass(TSubclassOf<AActor> standIn)
+{
+	const TSoftClassPtr<AActor> standInClass(standIn.Get());
+	basicTileClass = standInClass;
+	rightCornerTileClass = standInClass;
+	leftCornerTileClass = standInClass;
+	jumpTileClass = standInClass;
+	slideTileClass = standInClass;
+	vaultTileClass = standInClass;
+	swarmTileClass = standInClass;
+	leftCliffTileClass = standInClass;
+	rightCliffTileClass = standInClass;
+	PrewarmTilePools();
+}
+
+void ABetaArcadeGameMode::UseNativeScroller()
+{
+	useNativeScroller = true;
+	trackScroller->SetActive(true);
+	trackScroller->scrollVelocity = GetMapVelocity();
+}
+
+AActor* ABetaArcadeGameMode::SpawnTileFromPool(const TSoftClassPtr<AActor>& tileClass, FVector spawnLocation, FRotator spawnRotation, ETileType tileType)
+{
+	BETAARCADE_LLM_SCOPE(Tiles);
+
+	// The track can't continue without basic and corner tiles, so those are always allowed to block
+	UClass* resolvedClass = ResolveTileClass(tileClass, CanBlockOnTileClass(tileType));
+	if (!resolvedClass)
+	{
+		return NULL;
+	}
+
+	AActor* tile = NULL;
+	UTilePoolSubsystem* pool = GetWorld()->GetSubsystem<UTilePoolSubsystem>();
+	if (pool)
+	{
+		tile = pool->Acquire(resolvedClass, spawnLocation, spawnRotation, this);
+	}
+	else
+	{
+		FActorSpawnParameters spawnParams;
+		spawnParams.Owner = this;
+
+		tile = GetWorld()->SpawnActor<AActor>(resolvedClass, spawnLocation, spawnRotation, spawnParams);
+	}
+
+	RegisterSpawnedActor(tile, false, tileType);
+	return tile;
+}
+
+void ABetaArcadeGameMode::RegisterSpawnedActor(AActor* actor, bool decorative, ETileType tileType)
+{
+	if (!actor)
+	{
+		return;
+	}
+
+	if (trackScroller->IsActive())
+	{
+		trackScroller->AddSegment(actor, decorative); // Decoration has nothing to overlap
+	}
+	if (trackInstanceManager)
+	{
+		trackInstanceManager->RegisterActor(actor);
+	}
+	if (!decorative)
+	{
+		// Here rather than at the spawn so tiles from the scheduler are traced too
+		FBetaArcadeTrace::TileSpawned((uint8)tileType);
+		if (UHitchMonitor* hitchMonitor = GetWorld()->GetSubsystem<UHitchMonitor>())
+		{
+			hitchMonitor->NoteTileSpawned(tileType);
+		}
+		AddToTrackIndex(actor, tileType);
+	}
+}
+
+void ABetaArcadeGameMode::AddToTrackIndex(AActor* tile, ETileType tileType)
+{
+	UTrackSpatialIndex* trackIndex = GetWorld()->GetSubsystem<UTrackSpatialIndex>();
+	APawn* player = UGameplayStatics::GetPlayerPawn(this, 0);
+	if (!trackIndex || !player)
+	{
+		return;
+	}
+
+	// The player runs against mapDirection, so distance ahead of them is along -mapDirection
+	const FVector forward = -mapDirection.GetSafeNormal();
+	const FVector right = FVector::CrossProduct(FVector::UpVector, forward);
+	const FVector playerLocation = player->GetActorLocation();
+	const FVector tileLocation = tile->GetActorLocation();
+
+	trackIndex->Add(tile, trackDistanceTravelled + FVector::DotProduct(tileLocation - playerLocation, forward), 0, ETrackEntryKind::eTile, tileType);
+
+	// Obstacles and pickups the tile Blueprint spawned, their lane is taken from the tile's centre line
+	TArray<AActor*> attachedActors;
+	tile->GetAttachedActors(attachedActors);
+	for (AActor* attached : attachedActors)
+	{
+		const FVector location = attached->GetActorLocation();
+		const ETrackEntryKind kind = attached->IsA<APickUpBase>() ? ETrackEntryKind::ePickUp : ETrackEntryKind::eObstacle;
+		trackIndex->Add(attached, trackDistanceTravelled + FVector::DotProduct(location - playerLocation, forward),
+			UTrackSpatialIndex::GetLane(FVector::DotProduct(location - tileLocation, right)), kind, tileType);
+	}
+}
+
+void ABetaArcadeGameMode::RemoveFromTrackIndex(AActor* tile)
+{
+	UTrackSpatialIndex* trackIndex = GetWorld()->GetSubsystem<UTrackSpatialIndex>();
+	if (trackIndex)
+	{
+		TArray<AActor*> attachedActors;
+		tile->GetAttachedActors(attachedActors);
+		for (AActor* attached : attachedActors)
+		{
+			trackIndex->Remove(attached);
+		}
+		trackIndex->Remove(tile);
+	}
+}
+
+void ABetaArcadeGameMode::PreloadTileClasses()
+{
+	UGameInstance* gameInstance = GetGameInstance();
+	UTileAssetLoader* loader = gameInstance ? gameInstance->GetSubsystem<UTileAssetLoader>() : NULL;
+	if (loader)
+	{
+		TArray<TSoftClassPtr<AActor>> classes = { basicTileClass, vaultTileClass, slideTileClass, jumpTileClass, swarmTileClass,
+			leftCliffTileClass, rightCliffTileClass, leftCornerTileClass, rightCornerTileClass, floatingIslandClass };
+		classes.Append(floatingIslandVariants);
+
+		tileLoadHandle = loader->RequestClasses(classes, isMenu ? FStreamableDelegate() : FStreamableDelegate::CreateUObject(this, &ABetaArcadeGameMode::PrewarmTilePools));
+	}
+	else if (!isMenu)
+	{
+		PrewarmTilePools();
+	}
+}
+
+bool ABetaArcadeGameMode::IsMenuMap() const
+{
+	const FString defaultMap = FPackageName::GetShortName(FPackageName::ObjectPathToPackageName(UGameMapsSettings::GetGameDefaultMap()));
+	return !defaultMap.IsEmpty() && UGameplayStatics::GetCurrentLevelName(this) == defaultMap;
+}
+
+UClass* ABetaArcadeGameMode::ResolveTileClass(const TSoftClassPtr<AActor>& tileClass, bool bBlockIfNotLoaded)
+{
+	UGameInstance* gameInstance = GetGameInstance();
+	UTileAssetLoader* loader = gameInstance ? gameInstance->GetSubsystem<UTileAssetLoader>() : NULL;
+	if (loader)
+	{
+		return loader->ResolveClass(tileClass, bBlockIfNotLoaded);
+	}
+
+	return bBlockIfNotLoaded ? tileClass.LoadSynchronous() : tileClass.Get();
+}
+
+bool ABetaArcadeGameMode::CanBlockOnTileClass(ETileType tileType) const
+{
+	return tileType == ETileType::eBasic || tileType == ETileType::eCorner || waitForUnloadedTiles;
+}
+
+bool ABetaArcadeGameMode::IsTileTypeResident(ETileType tileType)
+{
+	switch (tileType)
+	{
+	case ETileType::eVault:
+		return ResolveTileClass(vaultTileClass, waitForUnloadedTiles) != NULL;
+	case ETileType::eSlide:
+		return ResolveTileClass(slideTileClass, waitForUnloadedTiles) != NULL;
+	case ETileType::eJump:
+		return ResolveTileClass(jumpTileClass, waitForUnloadedTiles) != NULL;
+	case ETileType::eSwarm:
+		return ResolveTileClass(swarmTileClass, waitForUnloadedTiles) != NULL;
+	case ETileType::eCliff:
+		return ResolveTileClass(leftCliffTileClass, waitForUnloadedTiles) != NULL && ResolveTileClass(rightCliffTileClass, waitForUnloadedTiles) != NULL;
+	default:
+		return true;
+	}
+}
+
+void ABetaArcadeGameMode::RecycleTile(AActor* tile)
+{
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_RecycleTile);
+	BETAARCADE_ALLOCATION_SCOPE("RecycleTile");
+
+	if (tile)
+	{
+		// Keep the slack, the array refills as soon as the next tile spawns
+		const int tileIndex = currentTiles.Find(tile);
+		if (tileIndex != INDEX_NONE)
+		{
+			currentTiles.RemoveAt(tileIndex, 1, false);
+		}
+		trackScroller->RemoveSegment(tile);
+		RemoveFromTrackIndex(tile);
+		if (trackInstanceManager)
+		{
+			trackInstanceManager->UnregisterActor(tile);
+		}
+
+		UTilePoolSubsystem* pool = GetWorld()->GetSubsystem<UTilePoolSubsystem>();
+		if (!pool || !pool->Release(tile))
+		{
+			tile->Destroy();
+		}
+	}
+}
+
+void ABetaArcadeGameMode::LogTilePoolStats()
+{
+	UTilePoolSubsystem* pool = GetWorld() ? GetWorld()->GetSubsystem<UTilePoolSubsystem>() : NULL;
+	if (pool)
+	{
+		pool->LogStats();
+	}
+}
+
+AActor* ABetaArcadeGameMode::SpawnStartTile() // Spawn Start Tiles with no obstacles at start of Game
+{
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_SpawnStartTile);
+
+	UWorld* world = GetWorld();
+	if (world)
+	{
+		spawnedTile = SpawnTileFromPool(basicTileClass, nextTileLocation, nextTileRotation);
 		return spawnedTile;
 	}
 	return NULL;
@@ -34,24 +411,20 @@ AActor* ABetaArcadeGameMode::SpawnStartTile() // Spawn Start Tiles with no obsta
 
 AActor* ABetaArcadeGameMode::SpawnCornerTile(FVector spawnLocation, FRotator spawnRotation) // Spawn Corner Tile
 {
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_SpawnCornerTile);
+	BETAARCADE_ALLOCATION_SCOPE("SpawnTile");
 
 	UWorld* world = GetWorld();
 	if (world)
 	{
-		FActorSpawnParameters spawnParams;
-		spawnParams.Owner = this;
-
-		tileToSpawn = ETileType::eCorner;
-
-		leftRight = FMath::RandRange(0, 9);
-		if (leftRight <= 4) //Left
+		if (PickCornerSide()) //Left
 		{
-			spawnedTile = world->SpawnActor<AActor>(leftCornerTileClass, spawnLocation, spawnRotation, spawnParams);
+			spawnedTile = SpawnTileFromPool(leftCornerTileClass, spawnLocation, spawnRotation, ETileType::eCorner);
 			return spawnedTile;
 		}
 		else //Right
 		{
-			spawnedTile = world->SpawnActor<AActor>(rightCornerTileClass, spawnLocation, spawnRotation, spawnParams);
+			spawnedTile = SpawnTileFromPool(rightCornerTileClass, spawnLocation, spawnRotation, ETileType::eCorner);
 			return spawnedTile;
 		}
 	}
@@ -79,19 +452,19 @@ void ABetaArcadeGameMode::SetNewTransforms(FVector nextLocation, FRotator nextRo
 
 AActor* ABetaArcadeGameMode::SpawnRandomTile(FVector spawnLocation, FRotator spawnRotation) // Random Tile Spawn Function
 {
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_SpawnRandomTile);
+	BETAARCADE_ALLOCATION_SCOPE("SpawnTile");
 
 	UWorld* world = GetWorld();
 	if (world)
 	{
-		tileToSpawn = GetNextTileType(); // Tile Type is Selected Ranomly here
-		FActorSpawnParameters spawnParams;
-		spawnParams.Owner = this;
+		tileToSpawn = PickRandomTileType(); // Tile Type is Selected Ranomly here
 
 		switch (tileToSpawn) // Use a Switch to Spawn different Tiles
 		{
 		case ETileType::eBasic:
 			eSpawnedTile = ETileType::eBasic;
-			spawnedTile = world->SpawnActor<AActor>(basicTileClass, spawnLocation, spawnRotation, spawnParams);
+			spawnedTile = SpawnTileFromPool(basicTileClass, spawnLocation, spawnRotation, tileToSpawn);
 			spawnedTiles++;
 			return spawnedTile;
 			break;
@@ -116,53 +489,47 @@ AActor* ABetaArcadeGameMode::SpawnRandomTile(FVector spawnLocation, FRotator spa
 		//Obstacles
 		case ETileType::eVault:
 			eSpawnedTile = ETileType::eVault;
-			spawnedTile = world->SpawnActor<AActor>(vaultTileClass, spawnLocation, spawnRotation, spawnParams);
+			spawnedTile = SpawnTileFromPool(vaultTileClass, spawnLocation, spawnRotation, tileToSpawn);
 			spawnedTiles++;
-			elastObstacleTile = ETileType::eVault;
 			currentTiles.Add(spawnedTile);
 			return spawnedTile;
 			break;
 		case ETileType::eSlide:
 			eSpawnedTile = ETileType::eSlide;
-			spawnedTile = world->SpawnActor<AActor>(slideTileClass, spawnLocation, spawnRotation, spawnParams);
+			spawnedTile = SpawnTileFromPool(slideTileClass, spawnLocation, spawnRotation, tileToSpawn);
 			spawnedTiles++;
-			elastObstacleTile = ETileType::eSlide;
 			currentTiles.Add(spawnedTile);
 			return spawnedTile;
 			break;
 		case ETileType::eJump:
 			eSpawnedTile = ETileType::eJump;
-			spawnedTile = world->SpawnActor<AActor>(jumpTileClass, spawnLocation, spawnRotation, spawnParams);
+			spawnedTile = SpawnTileFromPool(jumpTileClass, spawnLocation, spawnRotation, tileToSpawn);
 			spawnedTiles++;
-			elastObstacleTile = ETileType::eJump;
 			currentTiles.Add(spawnedTile);
 			return spawnedTile;
 			break;
 		case ETileType::eSwarm:
 			eSpawnedTile = ETileType::eSwarm;
-			spawnedTile = world->SpawnActor<AActor>(swarmTileClass, spawnLocation, spawnRotation, spawnParams);
+			spawnedTile = SpawnTileFromPool(swarmTileClass, spawnLocation, spawnRotation, tileToSpawn);
 			//eSpawnedTile = ETileType::eBasic;
 			//spawnedTile = world->SpawnActor<AActor>(basicTileClass, spawnLocation, spawnRotation, spawnParams);
 			spawnedTiles++;
-			elastObstacleTile = ETileType::eSwarm;
 			currentTiles.Add(spawnedTile);
 			return spawnedTile;
 			break;
 		case ETileType::eCliff:
 			eSpawnedTile = ETileType::eCliff;
-			leftRight = FMath::RandRange(0, 9);
-			if (leftRight <= 4) // Left
+			if (nextPlannedTile.leftVariant) // Left
 			{
-				spawnedTile = world->SpawnActor<AActor>(leftCliffTileClass, spawnLocation, spawnRotation, spawnParams);
+				spawnedTile = SpawnTileFromPool(leftCliffTileClass, spawnLocation, spawnRotation, tileToSpawn);
 				spawnedTiles++;
 			}
 			else // Right
 			{
-				spawnedTile = world->SpawnActor<AActor>(rightCliffTileClass, spawnLocation, spawnRotation, spawnParams);
+				spawnedTile = SpawnTileFromPool(rightCliffTileClass, spawnLocation, spawnRotation, tileToSpawn);
 				spawnedTiles++;
 			}
 			currentTiles.Add(spawnedTile);
-			elastObstacleTile = ETileType::eCliff;
 			return spawnedTile;
 			break;
 		default:
@@ -175,109 +542,222 @@ AActor* ABetaArcadeGameMode::SpawnRandomTile(FVector spawnLocation, FRotator spa
 
 void ABetaArcadeGameMode::ClearTileArray()
 {
-	currentTiles.Empty();
+	currentTiles.Reset();
 }
 
 ETileType ABetaArcadeGameMode::GetNextTileType()
 {
-	if (tileToSpawn == ETileType::eBasic || tileToSpawn == ETileType::eCorner)
+	UpdateLookaheadHorizon();
+	if (trackPlanner.Pop(nextPlannedTile))
 	{
-		obstacleSpawn = FMath::RandRange(0, 99);
-		if (obstacleSpawn <= 50) // Lower Number to turn down Obstacle Spawning
-		{
-			//Spawn an Obstacle Tile
-			randomModule = FMath::RandRange(1, 9); // Obstacle Spawning is done with random number Generator
-			if (randomModule > 5)
-			{
-				duplicateTest = randomModule - 5;
-			}
-			else
-			{
-				duplicateTest = randomModule;
-			}
-			if (elastObstacleTile == ETileType(duplicateTest)) //To never get the same obstacle twice in a row
-			{
-				randomModule++;
-				if (randomModule > 9)
-				{
-					randomModule = 1;
-				}
-			}
+		return nextPlannedTile.tileType;
+	}
 
-			if (randomModule == 1 || randomModule == 6) // Vault
-			{
-				return ETileType::eVault;
-			}
-			else if (randomModule == 2 || randomModule == 7) // Slide
-			{
-				return ETileType::eSlide;
-			}
-			else if (randomModule == 3 || randomModule == 8) // Jump
-			{
-				return ETileType::eJump;
-			}
-			else if (randomModule == 4 || randomModule == 9) // Cliff
-			{
-				return ETileType::eCliff;
-			}
-			else if (randomModule == 5) // Swarm
-			{
-				return ETileType::eSwarm;
-			}
-			else
-			{
-				//ERROR
-				return ETileType::eBasic;
-			}
+	// Planner not started yet (called before BeginPlay)
+	nextPlannedTile.tileType = trackGenerator.NextTileType(tileToSpawn);
+	nextPlannedTile.leftVariant = trackGenerator.ChooseLeftVariant();
+	return nextPlannedTile.tileType;
+}
 
-			// Did originally use a Switch but this was not good to change individual tile spawn rates
-
-			//switch (randomModule)
-			//{
-			//case 1: //Vault
-			//	return ETileType::eVault;
-			//	break;
-			//case 2: //Slide
-			//	return ETileType::eSlide;
-			//	break;
-			//case 3: //Jump
-			//	return ETileType::eJump;
-			//	break;
-			//case 4: //Cliff
-			//	return ETileType::eCliff;
-			//	break;
-			//case 5: //Swarm
-			//	return ETileType::eSwarm;
-			//	break;
-			//default:
-			//	//ERROR
-			//	return ETileType::eBasic;
-			//	break;
-			//}
-		}
-		else
+ETileType ABetaArcadeGameMode::PickRandomTileType()
+{
+	ETileType tileType = GetNextTileType();
+	if (!IsTileTypeResident(tileType))
+	{
+		tileType = ETileType::eBasic; // Obstacle still streaming in, skip it rather than hitch
+	}
+	trackGenerator.RecordSpawnedTile(tileType);
+
+	return tileType;
+}
+
+bool ABetaArcadeGameMode::PickCornerSide()
+{
+	tileToSpawn = ETileType::eCorner;
+	trackGenerator.RecordSpawnedTile(tileToSpawn);
+
+	FPlannedTile upcoming;
+	return trackPlanner.PeekNext(upcoming) ? upcoming.cornerLeft : trackGenerator.ChooseLeftVariant();
+}
+
+const TSoftClassPtr<AActor>& ABetaArcadeGameMode::GetTileClass(ETileType tileType, bool leftVariant) const
+{
+	switch (tileType)
+	{
+	case ETileType::eVault:
+		return vaultTileClass;
+	case ETileType::eSlide:
+		return slideTileClass;
+	case ETileType::eJump:
+		return jumpTileClass;
+	case ETileType::eSwarm:
+		return swarmTileClass;
+	case ETileType::eCliff:
+		return leftVariant ? leftCliffTileClass : rightCliffTileClass;
+	case ETileType::eCorner:
+		return leftVariant ? leftCornerTileClass : rightCornerTileClass;
+	default:
+		return basicTileClass;
+	}
+}
+
+void ABetaArcadeGameMode::RequestRandomTile(FVector spawnLocation, FRotator spawnRotation)
+{
+	// The type is decided now so the track comes out in the same order as the synchronous path
+	tileToSpawn = PickRandomTileType();
+
+	FSpawnRequest request;
+	request.requestType = ESpawnRequestType::eTile;
+	request.tileType = tileToSpawn;
+	request.actorClass = ResolveTileClass(GetTileClass(tileToSpawn, nextPlannedTile.leftVariant), CanBlockOnTileClass(tileToSpawn));
+	request.transform = FTransform(spawnRotation, spawnLocation);
+	QueueSpawnRequest(request);
+}
+
+void ABetaArcadeGameMode::RequestCornerTile(FVector spawnLocation, FRotator spawnRotation)
+{
+	FSpawnRequest request;
+	request.requestType = ESpawnRequestType::eCorner;
+	request.tileType = ETileType::eCorner;
+	request.actorClass = ResolveTileClass(GetTileClass(ETileType::eCorner, PickCornerSide()), CanBlockOnTileClass(ETileType::eCorner));
+	request.transform = FTransform(spawnRotation, spawnLocation);
+	QueueSpawnRequest(request);
+}
+
+void ABetaArcadeGameMode::RequestFloatingIsland()
+{
+	if (spawnPointActors.Num() == 0)
+	{
+		return;
+	}
+
+	FSpawnRequest request;
+	request.requestType = ESpawnRequestType::eIsland;
+	request.actorClass = PickIslandClass();
+	request.transform = FTransform(islandRotation, GetIslandSpawnLocation());
+	if (request.actorClass)
+	{
+		QueueSpawnRequest(request);
+	}
+}
+
+void ABetaArcadeGameMode::QueueSpawnRequest(FSpawnRequest& request)
+{
+	APawn* player = UGameplayStatics::GetPlayerPawn(this, 0);
+	const float distanceToPlayer = player ? FVector::Dist(player->GetActorLocation(), request.transform.GetLocation()) : 0.0f;
+
+	spawnScheduler->QueueSpawn(request, distanceToPlayer, mapSpeed);
+}
+
+void ABetaArcadeGameMode::OnSpawnRequestFinished(AActor* actor, const FSpawnRequest& request)
+{
+	switch (request.requestType)
+	{
+	case ESpawnRequestType::eTile:
+		eSpawnedTile = request.tileType;
+		spawnedTiles++;
+		if (request.tileType != ETileType::eBasic)
 		{
-			return ETileType::eBasic;
+			currentTiles.Add(actor);
 		}
+		RegisterSpawnedActor(actor, false, request.tileType);
+		break;
+	case ESpawnRequestType::eCorner:
+		RegisterSpawnedActor(actor, false, ETileType::eCorner);
+		break;
+	case ESpawnRequestType::eIsland:
+		RegisterSpawnedActor(actor, true);
+		islandManager->AddIsland(actor);
+		break;
 	}
-	else
+
+	spawnedTile = actor;
+	OnScheduledSpawn.Broadcast(actor, request);
+}
+
+void ABetaArcadeGameMode::UpdateLookaheadHorizon()
+{
+	// SpeedBoost raises mapSpeed, so more tiles are needed to cover the same warning time
+	const int tilesNeeded = FMath::CeilToInt(mapSpeed * lookaheadSeconds / FMath::Max(tileLength, 1.0f));
+	if (tilesNeeded != trackPlanner.GetHorizon())
 	{
-		return ETileType::eBasic;
+		trackPlanner.SetHorizon(tilesNeeded);
 	}
 }
 
+TArray<FPlannedTile> ABetaArcadeGameMode::GetUpcomingTiles(int maxTiles)
+{
+	TArray<FPlannedTile> upcoming;
+	trackPlanner.Peek(upcoming, maxTiles);
+
+	if (upcoming.Num() > 0)
+	{
+		const float firstDistance = upcoming[0].trackDistance;
+		const FVector forward = nextTileRotation.Vector();
+		for (FPlannedTile& planned : upcoming)
+		{
+			// Straight line from the next spawn point, the level may still turn a corner in between
+			const FVector location = nextTileLocation + forward * (planned.trackDistance - firstDistance);
+			planned.worldTransform = FTransform(nextTileRotation, location);
+			planned.cornerRotation = nextTileRotation + FRotator(0.0f, planned.cornerLeft ? -90.0f : 90.0f, 0.0f);
+		}
+	}
+
+	return upcoming;
+}
+
 void ABetaArcadeGameMode::SpawnFloatingIsland() // Spawn Level Floating Islands
 {
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_SpawnFloatingIsland);
+	BETAARCADE_LLM_SCOPE(Islands);
+
 	UWorld* world = GetWorld();
 	if (world)
 	{
-		FActorSpawnParameters spawnParams;
-		spawnParams.Owner = this;
-
 		islandLocation = GetIslandSpawnLocation();
 
-		world->SpawnActor<AActor>(floatingIslandClass, islandLocation, islandRotation, spawnParams);
+		UClass* islandClass = PickIslandClass();
+		UTilePoolSubsystem* pool = world->GetSubsystem<UTilePoolSubsystem>();
+		AActor* island = NULL;
+		if (islandClass && pool)
+		{
+			island = pool->Acquire(islandClass, islandLocation, islandRotation, this);
+		}
+		else if (islandClass)
+		{
+			FActorSpawnParameters spawnParams;
+			spawnParams.Owner = this;
+
+			island = world->SpawnActor<AActor>(islandClass, islandLocation, islandRotation, spawnParams);
+		}
+		RegisterSpawnedActor(island, true); // Islands are decoration, nothing overlaps them
+		islandManager->AddIsland(island);
+	}
+}
+
+UClass* ABetaArcadeGameMode::PickIslandClass()
+{
+	// Variants that are still streaming in are skipped, islands are never worth a hitch
+	TArray<UClass*, TInlineAllocator<8>> residentClasses;
+	if (UClass* islandClass = ResolveTileClass(floatingIslandClass, false))
+	{
+		residentClasses.Add(islandClass);
 	}
+	for (const TSoftClassPtr<AActor>& variant : floatingIslandVariants)
+	{
+		if (UClass* islandClass = ResolveTileClass(variant, false))
+		{
+			residentClasses.Add(islandClass);
+		}
+	}
+
+	return residentClasses.Num() > 0 ? residentClasses[FMath::RandRange(0, residentClasses.Num() - 1)] : NULL;
+}
+
+void ABetaArcadeGameMode::RecycleIsland(AActor* island)
+{
+	// Same route as tiles, off the scroller and instancer and back into the pool
+	RecycleTile(island);
 }
 
 FVector ABetaArcadeGameMode::GetIslandSpawnLocation()
@@ -5,19 +5,13 @@
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
 #include "Math.h"
+#include "TrackGenerator.h"
+#include "TrackPlanner.h"
+#include "SpawnSchedulerComponent.h"
+#include "EffectPoolSubsystem.h"
 #include "BetaArcadeGameMode.generated.h"
 
-UENUM(BlueprintType)
-enum class ETileType : uint8 // Enum Class for Tile Type
-{
-	eBasic,
-	eVault,
-	eSlide,
-	eJump,
-	eCliff,
-	eSwarm,
-	eCorner,
-};
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnScheduledSpawn, AActor*, spawnedActor, FSpawnRequest, request);
 
 UCLASS(minimalapi)
 class ABetaArcadeGameMode : public AGameModeBase
@@ -28,15 +22,41 @@ public:
 
 	ABetaArcadeGameMode();
 
-private:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void Tick(float DeltaSeconds) override;
+
+	FVector GetMapVelocity() const { return mapDirection.GetSafeNormal() * mapSpeed; }
 
-	int leftRight; // Used to Randomly select a Left or Right module
-	int randomModule;
-	int obstacleSpawn;
-	int duplicateTest;
+	// For BetaArcade.Census
+	int GetNumCurrentTiles() const { return currentTiles.Num(); }
+	const class UIslandManagerComponent* GetIslandManager() const { return islandManager; }
+	const class APickUpField* GetPickUpField() const { return pickUpField; }
+
+	// Headless benchmarks, one native class stands in for every Blueprint tile
+	void UseStandInTileClass(TSubclassOf<AActor> standIn);
+	void SetTileTransitionTable(class UDataTable* table) { tileTransitionTable = table; } // Compiled on BeginPlay
+	const FTrackGeneratorStats& GetTrackStats() const { return trackGenerator.stats; }
+	int GetTilePlanUnderflows() const { return trackPlanner.GetUnderflows(); }
+	FTrackGeneratorStats GetTilePlanStats() const { return trackPlanner.GetGeneratorStats(); }
+	void UseNativeScroller(); // For worlds that never run BeginPlay's scroller setup with useNativeScroller on
+	class UTrackScrollerComponent* GetTrackScroller() const { return trackScroller; }
+	const TSoftClassPtr<AActor>& GetBasicTileClass() const { return basicTileClass; }
+	float GetTileLength() const { return tileLength; }
+
+private:
 
 	AActor* spawnedTile;
-	ETileType elastObstacleTile = ETileType::eBasic;
+
+	// Obstacle selection and the no repeat rule live here so they can be benchmarked headless
+	FTrackGenerator trackGenerator;
+
+	// Upcoming tiles, planned ahead on a worker from a copy of trackGenerator
+	FTrackPlanner trackPlanner;
+	FPlannedTile nextPlannedTile;
+
+	// Waits on every tile class so the pools are prewarmed once they are resident
+	TSharedPtr<struct FStreamableHandle> tileLoadHandle;
 
 protected:
 
@@ -56,7 +76,20 @@ protected:
 	FVector GetIslandSpawnLocation();
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Island)
-		TSubclassOf<class AActor> floatingIslandClass;
+		TSoftClassPtr<class AActor> floatingIslandClass;
+
+	// Extra island looks, one is picked at random for each spawn along with floatingIslandClass
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Island)
+		TArray<TSoftClassPtr<class AActor>> floatingIslandVariants;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Island)
+		int islandPoolSize = 4; // Instances of each island variant created at level load
+
+	// Caps the live islands and recycles the ones the player has passed
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Island)
+		class UIslandManagerComponent* islandManager;
+
+	UClass* PickIslandClass();
+	void RecycleIsland(AActor* island);
 
 	int numOfSpawnPoints;
 	int randomSpawnPointIndex;
@@ -64,28 +97,74 @@ protected:
 	UFUNCTION(BlueprintCallable)
 		void ClearTileArray();
 
+	// Tile Pooling - tiles are handed out by UTilePoolSubsystem instead of being spawned and destroyed
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Pool)
+		int tilePoolSize = 4; // Instances of each tile class created at level load
+
+public:
+
+	UFUNCTION(BlueprintCallable)
+		void PrewarmTilePools();
+
+	// Call this instead of DestroyActor when a tile leaves the play area
+	UFUNCTION(BlueprintCallable)
+		void RecycleTile(AActor* tile);
+
+	UFUNCTION(BlueprintCallable)
+		void LogTilePoolStats();
+
+	AActor* SpawnTileFromPool(const TSoftClassPtr<AActor>& tileClass, FVector spawnLocation, FRotator spawnRotation, ETileType tileType = ETileType::eBasic);
+
+protected:
+
+	// Async Loading
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Loading)
+		bool waitForUnloadedTiles = false; // Block on obstacle classes that are still loading instead of spawning a basic tile
+
+	// Starts streaming every tile and island class, called on BeginPlay so it runs during the main menu.
+	// In the gameplay level the pools are prewarmed once every class is resident.
+	UFUNCTION(BlueprintCallable)
+		void PreloadTileClasses();
+
+	// The menu only streams the tile classes in for the level after it, the world is thrown away on travel so
+	// there is no planner, pool prewarm, effect prewarm, instance manager or pickup field.
+	// Also on for the project's default map, which is the main menu
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Loading)
+		bool isMenu = false;
+	bool IsMenuMap() const;
+
+	UClass* ResolveTileClass(const TSoftClassPtr<AActor>& tileClass, bool bBlockIfNotLoaded);
+	bool CanBlockOnTileClass(ETileType tileType) const; // Basic and corner tiles, or obstacles with waitForUnloadedTiles
+	bool IsTileTypeResident(ETileType tileType);
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Tile)
 		ETileType tileToSpawn;
 
 	// As Modules are Blueprint Classes, classes are defined in the Game Mode Blueprint
+	// Soft references so they can be streamed in during the main menu rather than with the Game Mode
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Tile)
-		TSubclassOf<class AActor> basicTileClass;
+		TSoftClassPtr<class AActor> basicTileClass;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Tile)
-		TSubclassOf<class AActor> rightCornerTileClass;
+		TSoftClassPtr<class AActor> rightCornerTileClass;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Tile)
-		TSubclassOf<class AActor> leftCornerTileClass;
+		TSoftClassPtr<class AActor> leftCornerTileClass;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Tile)
-		TSubclassOf<class AActor> jumpTileClass;
+		TSoftClassPtr<class AActor> jumpTileClass;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Tile)
-		TSubclassOf<class AActor> slideTileClass;
+		TSoftClassPtr<class AActor> slideTileClass;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Tile)
-		TSubclassOf<class AActor> vaultTileClass;
+		TSoftClassPtr<class AActor> vaultTileClass;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Tile)
-		TSubclassOf<class AActor> swarmTileClass;
+		TSoftClassPtr<class AActor> swarmTileClass;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Tile)
-		TSubclassOf<class AActor> leftCliffTileClass;
+		TSoftClassPtr<class AActor> leftCliffTileClass;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Tile)
-		TSubclassOf<class AActor> rightCliffTileClass;
+		TSoftClassPtr<class AActor> rightCliffTileClass;
+
+	// Odds of each tile following the last obstacle, compiled into the track generator on BeginPlay
+	// Leave empty to use the hard coded odds
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Tile)
+		class UDataTable* tileTransitionTable;
 
 	// Map Movement
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Speed)
@@ -95,9 +174,34 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Speed)
 		FVector mapSpeedVector = { 0.0f, 0.0f,0.0f };
 
+	// Moves all live tiles and islands natively, turn off the movement in the tile Blueprints when this is on
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Speed)
+		bool useNativeScroller = false;
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Speed)
+		class UTrackScrollerComponent* trackScroller;
+
+	// Instancing - repeated tile and island meshes are drawn through shared HISM components
+	// Needs useNativeScroller, the instances move with the scroller rather than with each tile
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Instancing)
+		TArray<class UStaticMesh*> instancedMeshes;
+	UPROPERTY(BlueprintReadOnly, Category = Instancing)
+		class ATrackInstanceManager* trackInstanceManager;
+
+	// Light orbs and points without an actor each, tile Blueprints add their orbs to pickUpField
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = PickUps)
+		TSubclassOf<class APickUpField> pickUpFieldClass;
+	UPROPERTY(BlueprintReadOnly, Category = PickUps)
+		class APickUpField* pickUpField;
+
+	// Niagara systems for pickups, swarms and combat, played from UEffectPoolSubsystem
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Effects)
+		TArray<FRunnerEffectConfig> effects;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite)
 		ETileType eSpawnedTile = ETileType::eBasic;
 
+public:
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = TileTransform)
 		FVector nextTileLocation = { 0.0f, 0.0f, 0.0f };
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = TileTransform)
@@ -118,10 +222,57 @@ protected:
 	UFUNCTION(BlueprintCallable)
 		AActor* SpawnRandomTile(FVector spawnLocation, FRotator spawnRotation);
 
+protected:
+
 	// Gets Random Obstacle
 	ETileType GetNextTileType();
 	int spawnedTiles;
 
+	// GetNextTileType, skipping anything not loaded yet, and records it
+	ETileType PickRandomTileType();
+	bool PickCornerSide();
+	const TSoftClassPtr<AActor>& GetTileClass(ETileType tileType, bool leftVariant) const;
+
+	// Hooks a tile or island up to the scroller and instancing once it is in the world
+	void RegisterSpawnedActor(AActor* actor, bool decorative, ETileType tileType = ETileType::eBasic);
+
+	// Spatial index - tiles and what is attached to them, by distance along the track and lane
+	UPROPERTY(BlueprintReadOnly, Category = Track)
+		float trackDistanceTravelled = 0.0f;
+
+	void AddToTrackIndex(AActor* tile, ETileType tileType);
+	void RemoveFromTrackIndex(AActor* tile);
+
+	// Spawn Scheduling - queued versions of the spawn functions, finished under a per frame budget
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Spawning)
+		class USpawnSchedulerComponent* spawnScheduler;
+
+	// Fired for every queued spawn once the actor is in the world, use it to chain SetNewTransforms
+	UPROPERTY(BlueprintAssignable)
+		FOnScheduledSpawn OnScheduledSpawn;
+
+	UFUNCTION(BlueprintCallable)
+		void RequestRandomTile(FVector spawnLocation, FRotator spawnRotation);
+	UFUNCTION(BlueprintCallable)
+		void RequestCornerTile(FVector spawnLocation, FRotator spawnRotation);
+	UFUNCTION(BlueprintCallable)
+		void RequestFloatingIsland();
+
+	void QueueSpawnRequest(FSpawnRequest& request);
+	void OnSpawnRequestFinished(AActor* actor, const FSpawnRequest& request);
+
+	// Lookahead
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Lookahead)
+		float lookaheadSeconds = 3.0f; // How far ahead tiles are planned, the tile count grows with mapSpeed
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Lookahead)
+		float tileLength = 1000.0f;
+
+	void UpdateLookaheadHorizon();
+
+	// What the track has coming, nearest first, placed from the next tile transform
+	UFUNCTION(BlueprintCallable)
+		TArray<FPlannedTile> GetUpcomingTiles(int maxTiles);
+
 public:
 
 	/*UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Transform)
@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BetaArcadeMemory.h"
+#include "HAL/LowLevelMemStats.h"
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+
+DECLARE_LLM_MEMORY_STAT(TEXT("Tiles"), STAT_TilesLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Islands"), STAT_IslandsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("PickUps"), STAT_PickUpsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Swarm"), STAT_SwarmLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Monster"), STAT_MonsterLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Effects"), STAT_EffectsLLM, STATGROUP_LLMFULL);
+
+DECLARE_LLM_MEMORY_STAT(TEXT("Tiles"), STAT_TilesSummaryLLM, STATGROUP_LLM);
+DECLARE_LLM_MEMORY_STAT(TEXT("Islands"), STAT_IslandsSummaryLLM, STATGROUP_LLM);
+DECLARE_LLM_MEMORY_STAT(TEXT("PickUps"), STAT_PickUpsSummaryLLM, STATGROUP_LLM);
+DECLARE_LLM_MEMORY_STAT(TEXT("Swarm"), STAT_SwarmSummaryLLM, STATGROUP_LLM);
+DECLARE_LLM_MEMORY_STAT(TEXT("Monster"), STAT_MonsterSummaryLLM, STATGROUP_LLM);
+DECLARE_LLM_MEMORY_STAT(TEXT("Effects"), STAT_EffectsSummaryLLM, STATGROUP_LLM);
+
+#endif
+
+void RegisterBetaArcadeLLMTags()
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	FLowLevelMemTracker& tracker = FLowLevelMemTracker::Get();
+	tracker.RegisterProjectTag((int32)EBetaArcadeLLMTag::Tiles, TEXT("Tiles"), GET_STATFNAME(STAT_TilesLLM), GET_STATFNAME(STAT_TilesSummaryLLM));
+	tracker.RegisterProjectTag((int32)EBetaArcadeLLMTag::Islands, TEXT("Islands"), GET_STATFNAME(STAT_IslandsLLM), GET_STATFNAME(STAT_IslandsSummaryLLM));
+	tracker.RegisterProjectTag((int32)EBetaArcadeLLMTag::PickUps, TEXT("PickUps"), GET_STATFNAME(STAT_PickUpsLLM), GET_STATFNAME(STAT_PickUpsSummaryLLM));
+	tracker.RegisterProjectTag((int32)EBetaArcadeLLMTag::Swarm, TEXT("Swarm"), GET_STATFNAME(STAT_SwarmLLM), GET_STATFNAME(STAT_SwarmSummaryLLM));
+	tracker.RegisterProjectTag((int32)EBetaArcadeLLMTag::Monster, TEXT("Monster"), GET_STATFNAME(STAT_MonsterLLM), GET_STATFNAME(STAT_MonsterSummaryLLM));
+	tracker.RegisterProjectTag((int32)EBetaArcadeLLMTag::Effects, TEXT("Effects"), GET_STATFNAME(STAT_EffectsLLM), GET_STATFNAME(STAT_EffectsSummaryLLM));
+#endif
+}
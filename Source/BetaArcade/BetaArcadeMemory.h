@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+
+// Low Level Memory Tracker tags for the runner, shown under stat LLM and in the -llmcsv output
+enum class EBetaArcadeLLMTag : LLM_TAG_TYPE
+{
+	Tiles = (LLM_TAG_TYPE)ELLMTag::ProjectTagStart,
+	Islands,
+	PickUps,
+	Swarm,
+	Monster,
+	Effects,
+};
+
+#define BETAARCADE_LLM_SCOPE(Tag) LLM_SCOPE((ELLMTag)EBetaArcadeLLMTag::Tag)
+
+// Same, for a tag only known at run time, BETAARCADE_LLM_SCOPE_BYTAG(island ? EBetaArcadeLLMTag::Islands : EBetaArcadeLLMTag::Tiles)
+#define BETAARCADE_LLM_SCOPE_BYTAG(TagValue) LLM_SCOPE((ELLMTag)(TagValue))
+
+#else
+
+#define BETAARCADE_LLM_SCOPE(Tag)
+#define BETAARCADE_LLM_SCOPE_BYTAG(TagValue)
+
+#endif
+
+// Called once from module startup, before anything is spawned
+void RegisterBetaArcadeLLMTags();
@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BetaArcadeTrace.h"
+#include "ProfilingDebugging/MiscTrace.h"
+
+UE_TRACE_CHANNEL_DEFINE(BetaArcadeChannel)
+
+UE_TRACE_EVENT_BEGIN(BetaArcade, TileSpawned)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint8, TileType)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(BetaArcade, PickUpCollected)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(int32, PickUpID)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(BetaArcade, Combat)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(bool, Entered)
+UE_TRACE_EVENT_END()
+
+void FBetaArcadeTrace::TileSpawned(uint8 tileType)
+{
+	UE_TRACE_LOG(BetaArcade, TileSpawned, BetaArcadeChannel)
+		<< TileSpawned.Cycle(FPlatformTime::Cycles64())
+		<< TileSpawned.TileType(tileType);
+
+	TRACE_BOOKMARK(TEXT("Tile %d"), tileType);
+}
+
+void FBetaArcadeTrace::PickUpCollected(int pickUpID)
+{
+	UE_TRACE_LOG(BetaArcade, PickUpCollected, BetaArcadeChannel)
+		<< PickUpCollected.Cycle(FPlatformTime::Cycles64())
+		<< PickUpCollected.PickUpID(pickUpID);
+
+	TRACE_BOOKMARK(TEXT("PickUp %d"), pickUpID);
+}
+
+void FBetaArcadeTrace::CombatChanged(bool entered)
+{
+	UE_TRACE_LOG(BetaArcade, Combat, BetaArcadeChannel)
+		<< Combat.Cycle(FPlatformTime::Cycles64())
+		<< Combat.Entered(entered);
+
+	if (entered)
+	{
+		TRACE_BOOKMARK(TEXT("Combat entered"));
+	}
+	else
+	{
+		TRACE_BOOKMARK(TEXT("Combat exited"));
+	}
+}
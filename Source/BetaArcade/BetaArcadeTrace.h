@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BetaArcade.h"
+#include "AllocationCounter.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+// Gameplay markers for Unreal Insights, turn on with -trace=cpu,bookmark,BetaArcade
+UE_TRACE_CHANNEL_EXTERN(BetaArcadeChannel, BETAARCADE_API)
+
+// A stat cycle counter and an Insights CPU scope of the same name, for gameplay entry points
+#define BETAARCADE_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(Stat)
+
+/**
+ * Marks gameplay events on the Insights timeline so frame spikes can be lined up with what the player was doing.
+ * Each marker is a BetaArcade channel event and a bookmark, none of them allocate.
+ */
+struct BETAARCADE_API FBetaArcadeTrace
+{
+	static void TileSpawned(uint8 tileType);
+	static void PickUpCollected(int pickUpID);
+	static void CombatChanged(bool entered);
+};
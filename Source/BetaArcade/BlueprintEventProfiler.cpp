@@ -0,0 +1,150 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BlueprintEventProfiler.h"
+#include "BetaArcade.h"
+#include "BetaArcadeBenchmark.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Blueprint Event Calls"), STAT_BlueprintEventCalls, STATGROUP_BetaArcade);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Blueprint Event ms"), STAT_BlueprintEventMs, STATGROUP_BetaArcade);
+
+namespace
+{
+	static const int NUM_BLUEPRINT_EVENTS = (int)EBlueprintEvent::Count;
+
+	const TCHAR* blueprintEventNames[NUM_BLUEPRINT_EVENTS] =
+	{
+		TEXT("AnimationState"),
+		TEXT("Combat"),
+		TEXT("SetPlayerSpeed"),
+		TEXT("GetMapSpeed"),
+		TEXT("LivesEvent"),
+		TEXT("LightWidgetOn"),
+		TEXT("LightWidgetOff"),
+		TEXT("CameraFlip"),
+		TEXT("PlayCombatSound"),
+		TEXT("PowerUpExpired"),
+		TEXT("VaultControl"),
+	};
+
+	// Game thread only, like the events themselves
+	FBlueprintEventStats currentFrame[NUM_BLUEPRINT_EVENTS];
+	FBlueprintEventStats lastFrame[NUM_BLUEPRINT_EVENTS];
+	FBlueprintEventStats runTotals[NUM_BLUEPRINT_EVENTS];
+	uint64 worstFrameCycles[NUM_BLUEPRINT_EVENTS] = {};
+	int64 runFrames = 0;
+	FDelegateHandle endFrameHandle;
+
+	void EndFrame()
+	{
+		int32 calls = 0;
+		uint64 cycles = 0;
+		for (int i = 0; i < NUM_BLUEPRINT_EVENTS; ++i)
+		{
+			calls += currentFrame[i].calls;
+			cycles += currentFrame[i].cycles;
+			worstFrameCycles[i] = FMath::Max(worstFrameCycles[i], currentFrame[i].cycles);
+
+			lastFrame[i] = currentFrame[i];
+			currentFrame[i] = FBlueprintEventStats();
+		}
+		runFrames++;
+
+		SET_DWORD_STAT(STAT_BlueprintEventCalls, calls);
+		SET_FLOAT_STAT(STAT_BlueprintEventMs, FPlatformTime::ToMilliseconds64(cycles));
+	}
+}
+
+void FBlueprintEventProfiler::Startup()
+{
+	if (!endFrameHandle.IsValid())
+	{
+		endFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&EndFrame);
+	}
+}
+
+void FBlueprintEventProfiler::Shutdown()
+{
+	FCoreDelegates::OnEndFrame.Remove(endFrameHandle);
+	endFrameHandle.Reset();
+}
+
+void FBlueprintEventProfiler::Record(EBlueprintEvent event, uint64 cycles)
+{
+	FBlueprintEventStats& frame = currentFrame[(int)event];
+	frame.calls++;
+	frame.cycles += cycles;
+
+	FBlueprintEventStats& run = runTotals[(int)event];
+	run.calls++;
+	run.cycles += cycles;
+}
+
+const FBlueprintEventStats& FBlueprintEventProfiler::GetLastFrame(EBlueprintEvent event)
+{
+	return lastFrame[(int)event];
+}
+
+const FBlueprintEventStats& FBlueprintEventProfiler::GetRun(EBlueprintEvent event)
+{
+	return runTotals[(int)event];
+}
+
+const TCHAR* FBlueprintEventProfiler::GetEventName(EBlueprintEvent event)
+{
+	return event < EBlueprintEvent::Count ? blueprintEventNames[(int)event] : TEXT("Unknown");
+}
+
+void FBlueprintEventProfiler::ResetRun()
+{
+	for (int i = 0; i < NUM_BLUEPRINT_EVENTS; ++i)
+	{
+		runTotals[i] = FBlueprintEventStats();
+		worstFrameCycles[i] = 0;
+	}
+	runFrames = 0;
+}
+
+void FBlueprintEventProfiler::LogRun()
+{
+	FString csv;
+	const FString runName = FDateTime::Now().ToString();
+	const int64 frames = FMath::Max<int64>(runFrames, 1);
+
+	double totalMs = 0.0;
+	for (int i = 0; i < NUM_BLUEPRINT_EVENTS; ++i)
+	{
+		const FBlueprintEventStats& run = runTotals[i];
+		if (run.calls == 0)
+		{
+			continue;
+		}
+
+		const double eventMs = FPlatformTime::ToMilliseconds64(run.cycles);
+		const double worstMs = FPlatformTime::ToMilliseconds64(worstFrameCycles[i]);
+		totalMs += eventMs;
+
+		UE_LOG(LogBetaArcade, Display, TEXT("  %-16s %8d calls %10.3f ms  %7.2f us/call  %6.2f per frame  worst frame %.3f ms"),
+			blueprintEventNames[i], run.calls, eventMs, eventMs * 1000.0 / run.calls, (double)run.calls / frames, worstMs);
+		csv += FString::Printf(TEXT("%s,%s,%d,%.3f,%.3f,%.3f,%.3f\n"),
+			*runName, blueprintEventNames[i], run.calls, eventMs, eventMs * 1000.0 / run.calls, (double)run.calls / frames, worstMs);
+	}
+
+	UE_LOG(LogBetaArcade, Display, TEXT("Blueprint events: %.3f ms over %lld frames, %.4f ms per frame"), totalMs, runFrames, totalMs / frames);
+	AppendBenchmarkCsv(TEXT("BlueprintEvents.csv"), TEXT("run,event,calls,totalMs,usPerCall,callsPerFrame,worstFrameMs"), csv);
+}
+
+static FAutoConsoleCommandWithArgs BlueprintEventsCommand(
+	TEXT("BetaArcade.BlueprintEvents"),
+	TEXT("BetaArcade.BlueprintEvents [reset] - logs calls and time per native to Blueprint event since the run started"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& args)
+	{
+		if (args.Num() > 0 && args[0] == TEXT("reset"))
+		{
+			FBlueprintEventProfiler::ResetRun();
+			return;
+		}
+		FBlueprintEventProfiler::LogRun();
+	}));
@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+// BlueprintImplementableEvents the native code calls, each one is a trip into the Blueprint VM
+enum class EBlueprintEvent : uint8
+{
+	AnimationState,
+	Combat,
+	SetPlayerSpeed,
+	GetMapSpeed,
+	LivesEvent,
+	LightWidgetOn,
+	LightWidgetOff,
+	CameraFlip,
+	PlayCombatSound,
+	PowerUpExpired,
+	VaultControl,
+	Count,
+};
+
+struct FBlueprintEventStats
+{
+	int32 calls = 0;
+	uint64 cycles = 0;
+};
+
+/**
+ * Counts calls and time spent in each native to Blueprint event, for the last frame and for the whole run.
+ * The character resets it on BeginPlay and logs the run on EndPlay (BetaArcade.BlueprintEventsLogOnEndPlay),
+ * BetaArcade.BlueprintEvents logs it any time.
+ * Stats show under stat BetaArcade, and each call is its own scope in Insights.
+ */
+class BETAARCADE_API FBlueprintEventProfiler
+{
+public:
+
+	// The module binds the end of frame from startup, so the per frame figures count every frame of the run
+	static void Startup();
+	static void Shutdown();
+
+	static void Record(EBlueprintEvent event, uint64 cycles);
+
+	static const FBlueprintEventStats& GetLastFrame(EBlueprintEvent event);
+	static const FBlueprintEventStats& GetRun(EBlueprintEvent event);
+	static const TCHAR* GetEventName(EBlueprintEvent event);
+
+	static void ResetRun();
+
+	// Logs the per event breakdown and appends it to Saved/Benchmarks/BlueprintEvents.csv
+	static void LogRun();
+
+	class FScope
+	{
+	public:
+
+		FScope(EBlueprintEvent inEvent) : event(inEvent), startCycles(FPlatformTime::Cycles64()) {}
+		~FScope() { Record(event, FPlatformTime::Cycles64() - startCycles); }
+
+	private:
+
+		EBlueprintEvent event;
+		uint64 startCycles;
+	};
+};
+
+// Times Call as the named event, BETAARCADE_BLUEPRINT_EVENT(CameraFlip, CameraFlip());
+#if !UE_BUILD_SHIPPING
+#define BETAARCADE_BLUEPRINT_EVENT(Event, Call) \
+	{ \
+		TRACE_CPUPROFILER_EVENT_SCOPE(BP_##Event); \
+		FBlueprintEventProfiler::FScope blueprintEventScope(EBlueprintEvent::Event); \
+		Call; \
+	}
+#else
+#define BETAARCADE_BLUEPRINT_EVENT(Event, Call) { Call; }
+#endif
@@ -0,0 +1,204 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EffectPoolSubsystem.h"
+#include "BetaArcade.h"
+#include "BetaArcadeMemory.h"
+#include "BetaArcadeTrace.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "NiagaraComponent.h"
+#include "NiagaraSystem.h"
+#include "RunnerSignificance.h"
+
+DECLARE_CYCLE_STAT(TEXT("Play Effect"), STAT_PlayEffect, STATGROUP_BetaArcade);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Effects Active"), STAT_EffectsActive, STATGROUP_BetaArcade);
+
+void UEffectPoolSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	pools.SetNum(NUM_RUNNER_EFFECTS);
+}
+
+void UEffectPoolSubsystem::Deinitialize()
+{
+	LogStats();
+	pools.Empty();
+
+	Super::Deinitialize();
+}
+
+void UEffectPoolSubsystem::Configure(const FRunnerEffectConfig& config)
+{
+	if (config.effect == ERunnerEffect::eNone || !config.system)
+	{
+		return;
+	}
+
+	FEffectPool& pool = pools[(int)config.effect];
+	pool.system = config.system;
+	pool.maxInstances = config.maxInstances;
+
+	while (pool.freeComponents.Num() < config.prewarm)
+	{
+		UNiagaraComponent* component = CreateComponent(pool.system);
+		if (!component)
+		{
+			break;
+		}
+		pool.freeComponents.Add(component);
+	}
+	pool.stats.freeCount = pool.freeComponents.Num();
+}
+
+UNiagaraComponent* UEffectPoolSubsystem::PlayEffect(ERunnerEffect effect, FVector location, FRotator rotation, USceneComponent* attachTo, AActor* instigator)
+{
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_PlayEffect);
+
+	FEffectPool& pool = pools[(int)effect];
+	if (!pool.system)
+	{
+		return nullptr;
+	}
+
+	UNiagaraComponent* component = nullptr;
+	if (pool.maxInstances > 0 && pool.activeComponents.Num() >= pool.maxInstances)
+	{
+		// At the cap, the oldest instance is restarted for this one
+		component = pool.activeComponents[0];
+		pool.activeComponents.RemoveAt(0, 1, false);
+		numActive--;
+		pool.stats.capped++;
+	}
+	else if (pool.freeComponents.Num() > 0)
+	{
+		component = pool.freeComponents.Pop(false);
+	}
+	else
+	{
+		component = CreateComponent(pool.system);
+		pool.stats.misses++;
+	}
+
+	if (!component)
+	{
+		return nullptr;
+	}
+
+	if (attachTo)
+	{
+		component->AttachToComponent(attachTo, FAttachmentTransformRules::KeepRelativeTransform);
+		component->SetRelativeLocationAndRotation(location, rotation);
+	}
+	else
+	{
+		if (component->GetAttachParent())
+		{
+			component->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+		}
+		component->SetWorldLocationAndRotation(location, rotation);
+	}
+	component->Activate(true);
+
+	if (URunnerSignificance* significance = GetWorld()->GetSubsystem<URunnerSignificance>())
+	{
+		significance->SetEffectInstigator(component, instigator);
+	}
+
+	pool.activeComponents.Add(component);
+	numActive++;
+	pool.stats.plays++;
+	pool.stats.activeCount = pool.activeComponents.Num();
+	pool.stats.freeCount = pool.freeComponents.Num();
+	pool.stats.highWater = FMath::Max(pool.stats.highWater, pool.stats.activeCount);
+	SET_DWORD_STAT(STAT_EffectsActive, numActive);
+
+	return component;
+}
+
+void UEffectPoolSubsystem::OnEffectFinished(UNiagaraComponent* component)
+{
+	// A capped instance that was restarted is still playing
+	if (!component || component->IsActive())
+	{
+		return;
+	}
+
+	for (FEffectPool& pool : pools)
+	{
+		const int index = pool.activeComponents.Find(component);
+		if (index == INDEX_NONE)
+		{
+			continue;
+		}
+
+		pool.activeComponents.RemoveAt(index, 1, false);
+		if (component->GetAttachParent())
+		{
+			component->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+		}
+		pool.freeComponents.Add(component);
+
+		if (URunnerSignificance* significance = GetWorld()->GetSubsystem<URunnerSignificance>())
+		{
+			significance->SetEffectInstigator(component, nullptr);
+		}
+
+		numActive--;
+		pool.stats.activeCount = pool.activeComponents.Num();
+		pool.stats.freeCount = pool.freeComponents.Num();
+		SET_DWORD_STAT(STAT_EffectsActive, numActive);
+		return;
+	}
+}
+
+UNiagaraComponent* UEffectPoolSubsystem::CreateComponent(UNiagaraSystem* system)
+{
+	BETAARCADE_LLM_SCOPE(Effects);
+
+	UWorld* world = GetWorld();
+	if (!world)
+	{
+		return nullptr;
+	}
+
+	UNiagaraComponent* component = NewObject<UNiagaraComponent>(world);
+	component->SetAutoActivate(false);
+	component->SetAutoDestroy(false);
+	component->SetAsset(system);
+	component->OnSystemFinished.AddDynamic(this, &UEffectPoolSubsystem::OnEffectFinished);
+	component->RegisterComponentWithWorld(world);
+	return component;
+}
+
+FEffectPoolStats UEffectPoolSubsystem::GetStats(ERunnerEffect effect) const
+{
+	return pools.IsValidIndex((int)effect) ? pools[(int)effect].stats : FEffectPoolStats();
+}
+
+void UEffectPoolSubsystem::LogStats() const
+{
+	for (int i = 0; i < pools.Num(); ++i)
+	{
+		if (!pools[i].system)
+		{
+			continue;
+		}
+
+		const FEffectPoolStats& stats = pools[i].stats;
+		UE_LOG(LogBetaArcade, Log, TEXT("Effect pool %s (%s): plays %d, misses %d, capped %d, high water %d, active %d, free %d"),
+			*UEnum::GetValueAsString((ERunnerEffect)i), *GetNameSafe(pools[i].system),
+			stats.plays, stats.misses, stats.capped, stats.highWater, stats.activeCount, stats.freeCount);
+	}
+}
+
+static FAutoConsoleCommandWithWorld EffectPoolsCommand(
+	TEXT("BetaArcade.EffectPools"),
+	TEXT("Logs plays, misses, capped plays and occupancy for each pooled effect type"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* world)
+	{
+		if (const UEffectPoolSubsystem* effectPool = world ? world->GetSubsystem<UEffectPoolSubsystem>() : nullptr)
+		{
+			effectPool->LogStats();
+		}
+	}));
@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EffectPoolSubsystem.generated.h"
+
+class UNiagaraComponent;
+class UNiagaraSystem;
+
+UENUM(BlueprintType)
+enum class ERunnerEffect : uint8
+{
+	eNone,
+	ePickUpPoints,
+	ePickUpLight,
+	ePickUpLife,
+	eSwarm,
+	eSwarmFailed,
+	eCombatStart,
+	eCombatEnd,
+};
+static const int NUM_RUNNER_EFFECTS = 8;
+
+// One effect type, set on the game mode
+USTRUCT(BlueprintType)
+struct FRunnerEffectConfig
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Effect)
+		ERunnerEffect effect = ERunnerEffect::eNone;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Effect)
+		UNiagaraSystem* system = nullptr;
+	// Most instances playing at once, past it the oldest is restarted. 0 for no cap
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Effect)
+		int32 maxInstances = 8;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Effect)
+		int32 prewarm = 2;
+};
+
+USTRUCT(BlueprintType)
+struct FEffectPoolStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = Pool)
+		int32 plays = 0;
+	// Plays that had to create a new component
+	UPROPERTY(BlueprintReadOnly, Category = Pool)
+		int32 misses = 0;
+	// Plays that restarted the oldest instance because the type was at its cap
+	UPROPERTY(BlueprintReadOnly, Category = Pool)
+		int32 capped = 0;
+	UPROPERTY(BlueprintReadOnly, Category = Pool)
+		int32 highWater = 0;
+	UPROPERTY(BlueprintReadOnly, Category = Pool)
+		int32 activeCount = 0;
+	UPROPERTY(BlueprintReadOnly, Category = Pool)
+		int32 freeCount = 0;
+};
+
+USTRUCT()
+struct FEffectPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		UNiagaraSystem* system = nullptr;
+	UPROPERTY()
+		TArray<UNiagaraComponent*> freeComponents;
+	UPROPERTY()
+		TArray<UNiagaraComponent*> activeComponents; // Oldest first
+
+	int32 maxInstances = 0;
+	FEffectPoolStats stats;
+};
+
+/**
+ * Pooled Niagara components for the one-shot effects of pickups, swarms and combat, so playing one
+ * doesn't create and initialise a component. Components go back to their pool when the system
+ * finishes, and each type is capped at maxInstances playing at once. The components have no owner,
+ * so URunnerSignificance is told which actor each one is playing for.
+ */
+UCLASS()
+class BETAARCADE_API UEffectPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Sets the system for an effect type and creates prewarm components for it
+	void Configure(const FRunnerEffectConfig& config);
+
+	// With attachTo, location and rotation are relative to it. The effect follows the instigator's significance
+	// level while it plays. Nothing plays for a type with no system
+	UFUNCTION(BlueprintCallable)
+		UNiagaraComponent* PlayEffect(ERunnerEffect effect, FVector location, FRotator rotation, USceneComponent* attachTo = nullptr, AActor* instigator = nullptr);
+
+	UFUNCTION(BlueprintCallable)
+		FEffectPoolStats GetStats(ERunnerEffect effect) const;
+
+	void LogStats() const;
+
+private:
+
+	UFUNCTION()
+		void OnEffectFinished(UNiagaraComponent* component);
+
+	UNiagaraComponent* CreateComponent(UNiagaraSystem* system);
+
+	UPROPERTY()
+		TArray<FEffectPool> pools; // One per ERunnerEffect
+
+	int32 numActive = 0;
+};
@@ -2,10 +2,13 @@
 
 
 #include "FloatingIsland.h"
+#include "BetaArcadeMemory.h"
 
 // Sets default values
 AFloatingIsland::AFloatingIsland()
 {
+	BETAARCADE_LLM_SCOPE(Islands);
+
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
@@ -15,7 +18,15 @@ AFloatingIsland::AFloatingIsland()
 void AFloatingIsland::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	URunnerTickManager::RegisterActor(this, ERunnerTickCategory::eIsland);
+}
+
+void AFloatingIsland::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	URunnerTickManager::UnregisterActor(this, ERunnerTickCategory::eIsland);
+
+	Super::EndPlay(EndPlayReason);
 }
 
 // Called every frame
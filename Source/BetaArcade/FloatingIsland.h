@@ -4,10 +4,11 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "RunnerTickManager.h"
 #include "FloatingIsland.generated.h"
 
 UCLASS()
-class BETAARCADE_API AFloatingIsland : public AActor
+class BETAARCADE_API AFloatingIsland : public AActor, public IRunnerTickable
 {
 	GENERATED_BODY()
 	
@@ -18,6 +19,7 @@ public:
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:	
 	// Called every frame
@@ -0,0 +1,184 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HitchMonitor.h"
+#include "BetaArcade.h"
+#include "BetaArcadeCharacter.h"
+#include "RunnerTickManager.h"
+#include "TilePoolSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/App.h"
+#include "Misc/Paths.h"
+#include "RenderCore.h"
+#include "UObject/UObjectGlobals.h"
+
+static TAutoConsoleVariable<float> CVarHitchThresholdMs(
+	TEXT("BetaArcade.HitchThresholdMs"),
+	50.0f,
+	TEXT("Frames longer than this write the last few seconds of gameplay to Saved/Logs/Hitches.log, 0 turns the hitch monitor off"));
+
+void UHitchMonitor::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FMemory::Memzero(history, sizeof(history));
+	preGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &UHitchMonitor::OnPreGarbageCollect);
+	postGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UHitchMonitor::OnPostGarbageCollect);
+}
+
+void UHitchMonitor::Deinitialize()
+{
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(preGarbageCollectHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(postGarbageCollectHandle);
+
+	// The ring still overlaps the last dump, but the hitch would be lost otherwise
+	if (dumpPending)
+	{
+		DumpHistory(pendingHitch, CVarHitchThresholdMs.GetValueOnGameThread());
+	}
+
+	if (hitchLog)
+	{
+		hitchLog->Close();
+		delete hitchLog;
+		hitchLog = nullptr;
+	}
+
+	Super::Deinitialize();
+}
+
+void UHitchMonitor::Tick(float DeltaTime)
+{
+	const float thresholdMs = CVarHitchThresholdMs.GetValueOnGameThread();
+	if (thresholdMs <= 0.0f)
+	{
+		tilesSpawnedThisFrame = 0;
+		gcMsThisFrame = 0.0f;
+		return;
+	}
+
+	UWorld* world = GetWorld();
+	ABetaArcadeCharacter* player = Cast<ABetaArcadeCharacter>(UGameplayStatics::GetPlayerCharacter(world, 0));
+	URunnerTickManager* tickManager = world->GetSubsystem<URunnerTickManager>();
+	UTilePoolSubsystem* pool = world->GetSubsystem<UTilePoolSubsystem>();
+
+	// Both times are for the frame that just finished, DeltaTime would be time dilated
+	FHitchFrame& frame = history[nextFrame];
+	frame.frameNumber = GFrameCounter;
+	frame.frameMs = FApp::GetDeltaTime() * 1000.0f;
+	frame.gameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	frame.gcMs = gcMsThisFrame;
+	frame.liveActors = (uint16)FMath::Min(world->GetActorCount(), (int32)MAX_uint16);
+	frame.pooledActors = pool ? (uint16)FMath::Min(pool->GetNumLiveActors(), (int32)MAX_uint16) : 0;
+	frame.tilesSpawned = tilesSpawnedThisFrame;
+	frame.lastTile = lastTileSpawned;
+	frame.characterState = player ? (uint8)player->GetCharacterState() : 0;
+	frame.powerState = player ? (uint8)player->currentPowerState : 0;
+	frame.islands = tickManager ? (uint8)FMath::Min(tickManager->GetNumRegistered(ERunnerTickCategory::eIsland), (int)MAX_uint8) : 0;
+	frame.swarms = tickManager ? (uint8)FMath::Min(tickManager->GetNumRegistered(ERunnerTickCategory::eSwarm), (int)MAX_uint8) : 0;
+	frame.pickUps = tickManager ? (uint8)FMath::Min(tickManager->GetNumRegistered(ERunnerTickCategory::ePickUp), (int)MAX_uint8) : 0;
+
+	nextFrame = (nextFrame + 1) % HITCH_HISTORY_FRAMES;
+	recordedFrames = FMath::Min(recordedFrames + 1, HITCH_HISTORY_FRAMES);
+	framesSinceDump++;
+	tilesSpawnedThisFrame = 0;
+	gcMsThisFrame = 0.0f;
+
+	if (frame.frameMs > thresholdMs)
+	{
+		hitchCount++;
+		if (dumpPending)
+		{
+			laterHitches++;
+		}
+		else
+		{
+			pendingHitch = frame;
+			dumpPending = true;
+		}
+	}
+
+	if (dumpPending && framesSinceDump >= HITCH_HISTORY_FRAMES)
+	{
+		DumpHistory(pendingHitch, thresholdMs);
+	}
+}
+
+ETickableTickType UHitchMonitor::GetTickableTickType() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UHitchMonitor::IsTickable() const
+{
+	const UWorld* world = GetWorld();
+	return world && world->IsGameWorld();
+}
+
+TStatId UHitchMonitor::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHitchMonitor, STATGROUP_Tickables);
+}
+
+void UHitchMonitor::NoteTileSpawned(ETileType tileType)
+{
+	tilesSpawnedThisFrame = (uint8)FMath::Min(tilesSpawnedThisFrame + 1, (int)MAX_uint8);
+	lastTileSpawned = (uint8)tileType;
+}
+
+void UHitchMonitor::OnPreGarbageCollect()
+{
+	gcStartTime = FPlatformTime::Seconds();
+}
+
+void UHitchMonitor::OnPostGarbageCollect()
+{
+	if (gcStartTime > 0.0)
+	{
+		gcMsThisFrame += (float)((FPlatformTime::Seconds() - gcStartTime) * 1000.0);
+		gcStartTime = 0.0;
+	}
+}
+
+void UHitchMonitor::DumpHistory(const FHitchFrame& hitch, float thresholdMs)
+{
+	const int hitchesInDump = laterHitches;
+	framesSinceDump = 0;
+	dumpPending = false;
+	laterHitches = 0;
+
+	if (!hitchLog)
+	{
+		const FString logPath = FPaths::ProjectLogDir() / TEXT("Hitches.log");
+		hitchLog = IFileManager::Get().CreateFileWriter(*logPath, FILEWRITE_Append | FILEWRITE_AllowRead);
+		if (!hitchLog)
+		{
+			UE_LOG(LogBetaArcade, Warning, TEXT("Could not open %s, hitch monitor is writing nothing"), *logPath);
+			return;
+		}
+	}
+
+	ANSICHAR line[256];
+	int length = FCStringAnsi::Snprintf(line, sizeof(line),
+		"hitch frame %llu %.1fms (threshold %.1fms), %d more hitches in these frames\n"
+		"# frame ms gameMs gcMs actors pooled tiles lastTile state power islands swarms pickups\n",
+		hitch.frameNumber, hitch.frameMs, thresholdMs, hitchesInDump);
+	hitchLog->Serialize(line, FMath::Clamp(length, 0, (int)sizeof(line) - 1));
+
+	// Oldest first
+	const int oldest = recordedFrames < HITCH_HISTORY_FRAMES ? 0 : nextFrame;
+	for (int i = 0; i < recordedFrames; ++i)
+	{
+		const FHitchFrame& frame = history[(oldest + i) % HITCH_HISTORY_FRAMES];
+		length = FCStringAnsi::Snprintf(line, sizeof(line), "%llu %.2f %.2f %.2f %u %u %u %u %u %u %u %u %u\n",
+			frame.frameNumber, frame.frameMs, frame.gameThreadMs, frame.gcMs, frame.liveActors, frame.pooledActors,
+			frame.tilesSpawned, frame.lastTile, frame.characterState, frame.powerState, frame.islands, frame.swarms, frame.pickUps);
+		hitchLog->Serialize(line, FMath::Clamp(length, 0, (int)sizeof(line) - 1));
+	}
+	hitchLog->Flush();
+
+	UE_LOG(LogBetaArcade, Warning, TEXT("Hitch of %.1fms on frame %llu, last %d frames written to Hitches.log"), hitch.frameMs, hitch.frameNumber, recordedFrames);
+}
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "TrackGenerator.h"
+#include "HitchMonitor.generated.h"
+
+// About five seconds at 60fps
+static const int HITCH_HISTORY_FRAMES = 300;
+
+/**
+ * Keeps the last few seconds of frame times along with what the game was doing, and writes them to
+ * Saved/Logs/Hitches.log when a frame goes over BetaArcade.HitchThresholdMs (0 turns it off).
+ * Recording a frame doesn't allocate, the history is a fixed ring and the dump formats into a fixed buffer.
+ */
+UCLASS()
+class BETAARCADE_API UHitchMonitor : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+	// The game mode reports each tile as it goes in, so a dump shows what was spawned in the frames before a hitch
+	void NoteTileSpawned(ETileType tileType);
+
+	int GetNumHitches() const { return hitchCount; }
+
+private:
+
+	// One frame of history, kept small so the whole ring stays in a few pages
+	struct FHitchFrame
+	{
+		uint64 frameNumber;
+		float frameMs;
+		float gameThreadMs;
+		float gcMs;
+		uint16 liveActors;
+		uint16 pooledActors;
+		uint8 tilesSpawned;
+		uint8 lastTile;
+		uint8 characterState;
+		uint8 powerState;
+		uint8 islands;
+		uint8 swarms;
+		uint8 pickUps;
+	};
+
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+	void DumpHistory(const FHitchFrame& hitch, float thresholdMs);
+
+	FHitchFrame history[HITCH_HISTORY_FRAMES];
+	int nextFrame = 0;
+	int recordedFrames = 0;
+
+	// Gathered between frames and written into the next one
+	uint8 tilesSpawnedThisFrame = 0;
+	uint8 lastTileSpawned = 0;
+	double gcStartTime = 0.0;
+	float gcMsThisFrame = 0.0f;
+
+	// Only one dump per full ring, a long stutter would otherwise write the same frames again and again.
+	// A hitch inside a ring that was already written waits until the ring has refilled, then goes out with
+	// every hitch after it in the same dump
+	int framesSinceDump = HITCH_HISTORY_FRAMES;
+	int hitchCount = 0;
+	bool dumpPending = false;
+	FHitchFrame pendingHitch;
+	int laterHitches = 0; // Since pendingHitch
+
+	FDelegateHandle preGarbageCollectHandle;
+	FDelegateHandle postGarbageCollectHandle;
+
+	// Opened on the first hitch
+	FArchive* hitchLog = nullptr;
+};
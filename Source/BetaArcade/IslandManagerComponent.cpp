@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "IslandManagerComponent.h"
+#include "BetaArcade.h"
+#include "TilePoolSubsystem.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/Pawn.h"
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Live Islands"), STAT_LiveIslands, STATGROUP_BetaArcade);
+DECLARE_MEMORY_STAT(TEXT("Live Island Memory"), STAT_LiveIslandMemory, STATGROUP_BetaArcade);
+
+UIslandManagerComponent::UIslandManagerComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickInterval = 0.5f; // Islands drift by slowly, no need to check every frame
+}
+
+void UIslandManagerComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	APawn* player = UGameplayStatics::GetPlayerPawn(this, 0);
+	const FVector direction = mapDirection.GetSafeNormal();
+
+	for (int i = liveIslands.Num() - 1; i >= 0; --i)
+	{
+		AActor* island = liveIslands[i].island;
+		// Destroyed or already handed back to the pool by a Blueprint
+		if (!island || island->IsPendingKill() || island->IsHidden())
+		{
+			liveIslands.RemoveAt(i, 1, false);
+			continue;
+		}
+
+		if (player && FVector::DotProduct(island->GetActorLocation() - player->GetActorLocation(), direction) > recycleDistance)
+		{
+			RecycleAt(i);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_LiveIslands, liveIslands.Num());
+	SET_MEMORY_STAT(STAT_LiveIslandMemory, GetLiveIslandBytes());
+}
+
+void UIslandManagerComponent::AddIsland(AActor* island)
+{
+	if (!island)
+	{
+		return;
+	}
+
+	// Oldest island is at the front
+	while (liveIslands.Num() >= maxLiveIslands && liveIslands.Num() > 0)
+	{
+		RecycleAt(0);
+	}
+
+	FLiveIsland live;
+	live.island = island;
+	live.spawnTime = GetWorld()->GetTimeSeconds();
+	liveIslands.Add(live);
+}
+
+int64 UIslandManagerComponent::GetLiveIslandBytes() const
+{
+	int64 bytes = 0;
+	for (const FLiveIsland& live : liveIslands)
+	{
+		bytes += UTilePoolSubsystem::GetActorBytes(live.island);
+	}
+	return bytes;
+}
+
+void UIslandManagerComponent::RecycleAt(int index)
+{
+	AActor* island = liveIslands[index].island;
+	liveIslands.RemoveAt(index, 1, false);
+	islandsRecycled++;
+
+	if (island)
+	{
+		if (OnRecycle.IsBound())
+		{
+			OnRecycle.Execute(island);
+		}
+		else
+		{
+			island->Destroy();
+		}
+	}
+}
@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "IslandManagerComponent.generated.h"
+
+DECLARE_DELEGATE_OneParam(FOnIslandRecycled, AActor*);
+
+USTRUCT()
+struct FLiveIsland
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		AActor* island = nullptr;
+
+	double spawnTime = 0.0;
+};
+
+/**
+ * Keeps the number of floating islands bounded. Islands that have scrolled past the player are
+ * handed back, and when the cap is reached the oldest island is recycled to make room.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class BETAARCADE_API UIslandManagerComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UIslandManagerComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// Starts tracking a freshly spawned island, recycling the oldest if we are at the cap
+	void AddIsland(AActor* island);
+
+	// The owner releases the island to the pool and unhooks it from the scroller
+	FOnIslandRecycled OnRecycle;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Island)
+		int maxLiveIslands = 12;
+
+	// How far behind the player an island has to be before it is recycled
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Island)
+		float recycleDistance = 3000.0f;
+
+	// Direction the map travels in, islands further along it than the player are behind
+	FVector mapDirection = { -1.0f, 0.0f, 0.0f };
+
+	UFUNCTION(BlueprintCallable)
+		int GetNumLiveIslands() const { return liveIslands.Num(); }
+
+	// Rough size of the live islands and their components
+	UFUNCTION(BlueprintCallable)
+		int64 GetLiveIslandBytes() const;
+
+	UPROPERTY(BlueprintReadOnly, Category = Island)
+		int islandsRecycled = 0;
+
+private:
+
+	void RecycleAt(int index);
+
+	UPROPERTY()
+		TArray<FLiveIsland> liveIslands;
+};
@@ -1,11 +1,17 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "Monster.h"
+#include "BetaArcadeMemory.h"
 #include "Components/CapsuleComponent.h"
+#include "BetaArcadeTrace.h"
+
+DECLARE_CYCLE_STAT(TEXT("Monster Distance"), STAT_MonsterDistance, STATGROUP_BetaArcade);
 
 // Sets default values
 AMonster::AMonster()
 {
+	BETAARCADE_LLM_SCOPE(Monster);
+
 	// Set this pawn to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
@@ -21,8 +27,18 @@ AMonster::AMonster()
 // Called when the game starts or when spawned
 void AMonster::BeginPlay()
 {
+	BETAARCADE_LLM_SCOPE(Monster);
+
 	Super::BeginPlay();
 
+	URunnerTickManager::RegisterActor(this, ERunnerTickCategory::eMonster);
+}
+
+void AMonster::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	URunnerTickManager::UnregisterActor(this, ERunnerTickCategory::eMonster);
+
+	Super::EndPlay(EndPlayReason);
 }
 
 // Called every frame
@@ -34,24 +50,38 @@ void AMonster::Tick(float DeltaTime)
 
 void AMonster::UpdateMonsterDistance(int playerLives, float currentPlayerXPos)
 {
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_MonsterDistance);
+
+	if (gapDrivenBySimulation)
+	{
+		return;
+	}
+
+	if (playerLives > 0) // 0 is Player is Dead, stay where we are
+	{
+		SetGap(GetGapForLives(playerLives), currentPlayerXPos);
+	}
+}
 
+float AMonster::GetGapForLives(int playerLives) const
+{
 	switch (playerLives)
 	{
 	case 3:
-		newMonsterPos.X = currentPlayerXPos - playerThreeLivesDistance;
-		break;
+		return playerThreeLivesDistance;
 	case 2:
-		newMonsterPos.X = currentPlayerXPos - playerTwoLivesDistance;
-		break;
+		return playerTwoLivesDistance;
 	case 1:
-		newMonsterPos.X = currentPlayerXPos - playerOneLifeDistance;
-		break;
-	case 0:
-		// Player is Dead
-		break;
+		return playerOneLifeDistance;
 	default:
-		break;
+		return playerOneLifeDistance;
 	}
+}
+
+void AMonster::SetGap(float gap, float currentPlayerXPos)
+{
+	currentGap = gap;
+	newMonsterPos.X = currentPlayerXPos - gap;
 	newMonsterPos.Z = 110.0f;
 
 	this->SetActorLocation(newMonsterPos);
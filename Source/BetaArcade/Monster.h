@@ -4,10 +4,11 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Pawn.h"
+#include "RunnerTickManager.h"
 #include "Monster.generated.h"
 
 UCLASS()
-class BETAARCADE_API AMonster : public APawn
+class BETAARCADE_API AMonster : public APawn, public IRunnerTickable
 {
 	GENERATED_BODY()
 
@@ -23,6 +24,7 @@ protected:
 
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	// Monster position based on Player Lives
 	UPROPERTY(BlueprintReadOnly, Category = LifeDistance)
@@ -32,17 +34,32 @@ protected:
 	UPROPERTY(BlueprintReadOnly, Category = LifeDistance)
 		float playerThreeLivesDistance = 5000.0f;
 
-	UFUNCTION(BlueprintCallable)
-		void UpdateMonsterDistance(int playerLives, float currentPlayerXPos);
+	// Set once the player's simulation is placing the monster, UpdateMonsterDistance is ignored from then on
+	bool gapDrivenBySimulation = false;
 
 	UPROPERTY(BlueprintReadWrite, Category = MonsterPos)
 		FVector newMonsterPos = { 0.0f, 0.0f, 110.0f };
 
+	float currentGap = 0.0f;
+
 public:
 
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
+	// How far behind the player the monster sits for a number of lives
+	float GetGapForLives(int playerLives) const;
+
+	// Places the monster gap units behind the player
+	void SetGap(float gap, float currentPlayerXPos);
+
+	float GetGap() const { return currentGap; }
+
+	UFUNCTION(BlueprintCallable)
+		void UpdateMonsterDistance(int playerLives, float currentPlayerXPos);
+
+	void SetGapDrivenBySimulation(bool driven) { gapDrivenBySimulation = driven; }
+
 	// Called to bind functionality to input
 	//virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MonsterAnimInstance.h"
+#include "BetaArcadeGameMode.h"
+#include "BetaArcadeTrace.h"
+#include "Engine/World.h"
+#include "Monster.h"
+
+DECLARE_CYCLE_STAT(TEXT("Monster Anim Gather (game thread)"), STAT_MonsterAnimGather, STATGROUP_BetaArcade);
+DECLARE_CYCLE_STAT(TEXT("Monster Anim Update (game thread)"), STAT_MonsterAnimUpdateGameThread, STATGROUP_BetaArcade);
+DECLARE_CYCLE_STAT(TEXT("Monster Anim Update (worker)"), STAT_MonsterAnimUpdateWorker, STATGROUP_BetaArcade);
+
+void FMonsterAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
+{
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_MonsterAnimGather);
+
+	Super::PreUpdate(InAnimInstance, DeltaSeconds);
+
+	const UMonsterAnimInstance* animInstance = CastChecked<UMonsterAnimInstance>(InAnimInstance);
+	referenceRunSpeed = FMath::Max(animInstance->referenceRunSpeed, 1.0f);
+	blendSpeed = animInstance->blendSpeed;
+
+	const AMonster* monster = Cast<AMonster>(animInstance->TryGetPawnOwner());
+	if (!monster)
+	{
+		return;
+	}
+
+	gap = monster->GetGap();
+	nearGap = monster->GetGapForLives(1);
+	farGap = monster->GetGapForLives(3);
+
+	const ABetaArcadeGameMode* gameMode = monster->GetWorld()->GetAuthGameMode<ABetaArcadeGameMode>();
+	mapSpeed = gameMode ? gameMode->GetMapVelocity().Size() : 0.0f;
+}
+
+void FMonsterAnimInstanceProxy::Update(float DeltaSeconds)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(MonsterAnimUpdate);
+	FScopeCycleCounter cycleCounter(IsInGameThread() ? GET_STATID(STAT_MonsterAnimUpdateGameThread) : GET_STATID(STAT_MonsterAnimUpdateWorker));
+
+	Super::Update(DeltaSeconds);
+
+	runSpeed = mapSpeed;
+	runPlayRate = mapSpeed / referenceRunSpeed;
+	closeness = FMath::GetMappedRangeValueClamped(FVector2D(farGap, nearGap), FVector2D(0.0f, 1.0f), gap);
+
+	const bool closing = gap < previousGap - KINDA_SMALL_NUMBER;
+	closingAlpha = FMath::FInterpTo(closingAlpha, closing ? 1.0f : 0.0f, DeltaSeconds, blendSpeed);
+	previousGap = gap;
+}
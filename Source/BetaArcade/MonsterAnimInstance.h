@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "MonsterAnimInstance.generated.h"
+
+/**
+ * Monster blend parameters, gathered from the monster on the game thread in PreUpdate
+ * and worked out on an animation worker thread in Update.
+ */
+USTRUCT(BlueprintType)
+struct BETAARCADE_API FMonsterAnimInstanceProxy : public FAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+	FMonsterAnimInstanceProxy() {}
+	FMonsterAnimInstanceProxy(UAnimInstance* InAnimInstance) : FAnimInstanceProxy(InAnimInstance) {}
+
+	virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+	virtual void Update(float DeltaSeconds) override;
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Locomotion)
+		float runSpeed = 0.0f;
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Locomotion)
+		float runPlayRate = 1.0f;
+	// 0 at the three lives distance, 1 at the one life distance
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Chase)
+		float closeness = 0.0f;
+	// Eases to 1 while the gap is closing, for a lunge or roar blend
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Chase)
+		float closingAlpha = 0.0f;
+
+private:
+
+	float mapSpeed = 0.0f;
+	float gap = 0.0f;
+	float previousGap = 0.0f;
+	float nearGap = 0.0f;
+	float farGap = 1.0f;
+	float referenceRunSpeed = 1.0f;
+	float blendSpeed = 0.0f;
+};
+
+// Native parent for MonsterAnim_BP, see URunnerAnimInstance
+UCLASS(Transient, Blueprintable)
+class BETAARCADE_API UMonsterAnimInstance : public UAnimInstance
+{
+	GENERATED_BODY()
+
+	friend struct FMonsterAnimInstanceProxy;
+
+public:
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Locomotion)
+		float referenceRunSpeed = 4000.0f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Locomotion)
+		float blendSpeed = 4.0f;
+
+protected:
+
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override { return &proxy; }
+	virtual void DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy) override {}
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Locomotion, meta = (AllowPrivateAccess = "true"))
+		FMonsterAnimInstanceProxy proxy;
+};
@@ -7,6 +7,11 @@
 #include "PickUps/SpeedBoost.h"
 #include "PickUps/Magnet.h"
 #include "PickUps/BigScoreMultiplier.h"
+#include "BetaArcadeTrace.h"
+#include "BlueprintEventProfiler.h"
+
+DECLARE_CYCLE_STAT(TEXT("Hotbar Use"), STAT_HotbarUse, STATGROUP_BetaArcade);
+DECLARE_CYCLE_STAT(TEXT("Hotbar Add"), STAT_HotbarAdd, STATGROUP_BetaArcade);
 
 
 
@@ -22,12 +27,16 @@ UHotbarComp::UHotbarComp()
 void UHotbarComp::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	PickUpIDs.Reserve(NumSlots);
 }
 
 //Determines which power up function is called. 
 void UHotbarComp::HandleHotbar(int ID)
 {
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_HotbarUse);
+	BETAARCADE_ALLOCATION_SCOPE("Hotbar");
+
 	switch (ID)
 	{
 		case 1:
@@ -59,9 +68,10 @@ void UHotbarComp::SpeedBoostAction()
 {
 	if (Character != NULL)
 	{
-		Character->SetPlayerSpeed(6500);
+		BETAARCADE_BLUEPRINT_EVENT(SetPlayerSpeed, Character->SetPlayerSpeed(6500));
 		Character->scoreMultiplier = 2;
 		Character->currentPowerState = PowerState::State::SpeedBoost;
+		Character->StartPowerUpTimer(PowerState::State::SpeedBoost, Character->GetSpeedBoostDuration());
 		
 	}
 }
@@ -73,6 +83,7 @@ void UHotbarComp::BigScoreMultiplierAction()
 	{
 		Character->currentPowerState = PowerState::State::ScoreBonus;
 		Character->scoreMultiplier = 5;
+		Character->StartPowerUpTimer(PowerState::State::ScoreBonus, Character->GetScoreBonusDuration());
 		
 	}
 }
@@ -96,6 +107,7 @@ void UHotbarComp::MagnetAction()
 	{
 		Character->currentPowerState = PowerState::State::Magnet;
 		Character->isMagnetActive = true;
+		Character->StartPowerUpTimer(PowerState::State::Magnet, Character->GetMagnetDuration());
 		UE_LOG(LogTemp, Log, TEXT("Magnet true"));
 
 		RemovePickUp(3);
@@ -106,6 +118,8 @@ void UHotbarComp::MagnetAction()
 //Add PickUp to hotbar
 bool UHotbarComp::AddPickUp(class APickUpBase* PickUp)
 {
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_HotbarAdd);
+	BETAARCADE_ALLOCATION_SCOPE("Hotbar");
 
 	//Checks to see if pick up of that type is already in hotbar.
 	for(int i = 0; i < PickUpIDs.Num(); ++i)
@@ -139,7 +153,11 @@ bool UHotbarComp::AddPickUp(class APickUpBase* PickUp)
 //Remove pick up from hotbar
 void UHotbarComp::RemovePickUp(int ID)
 {
-	PickUpIDs.RemoveSingle(ID);
+	const int index = PickUpIDs.Find(ID);
+	if (index != INDEX_NONE)
+	{
+		PickUpIDs.RemoveAt(index, 1, false);
+	}
 	OnHotbarUpdated.Broadcast();
 }
 
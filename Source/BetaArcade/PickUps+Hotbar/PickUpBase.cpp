@@ -2,13 +2,45 @@
 
 
 #include "PickUpBase.h"
+#include "BetaArcadeMemory.h"
+#include "BetaArcadeCharacter.h"
 
 // Sets default values
 APickUpBase::APickUpBase()
 {
+	BETAARCADE_LLM_SCOPE(PickUps);
+
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
 }
 
+void APickUpBase::BeginPlay()
+{
+	// Blueprint BeginPlay allocations count against the actor too
+	BETAARCADE_LLM_SCOPE(PickUps);
+
+	Super::BeginPlay();
+
+	URunnerTickManager::RegisterActor(this, ERunnerTickCategory::ePickUp);
+}
+
+void APickUpBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	URunnerTickManager::UnregisterActor(this, ERunnerTickCategory::ePickUp);
+
+	Super::EndPlay(EndPlayReason);
+}
 
+void APickUpBase::PlayCollectEffect(class ABetaArcadeCharacter* Character) const
+{
+	if (collectEffect == ERunnerEffect::eNone || !Character)
+	{
+		return;
+	}
+
+	if (UEffectPoolSubsystem* effectPool = Character->GetWorld()->GetSubsystem<UEffectPoolSubsystem>())
+	{
+		effectPool->PlayEffect(collectEffect, FVector::ZeroVector, FRotator::ZeroRotator, Character->GetRootComponent(), this);
+	}
+}
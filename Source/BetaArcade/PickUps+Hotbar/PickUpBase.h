@@ -4,11 +4,13 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "RunnerTickManager.h"
+#include "EffectPoolSubsystem.h"
 #include "PickUpBase.generated.h"
 
 
 UCLASS(Abstract, BlueprintType, Blueprintable, DefaultToInstanced)
-class BETAARCADE_API APickUpBase : public AActor
+class BETAARCADE_API APickUpBase : public AActor, public IRunnerTickable
 {
 	GENERATED_BODY()
 	
@@ -23,6 +25,8 @@ public:
 		class UTexture2D* Thumbnail;
 protected:
 
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:	
 
@@ -36,6 +40,13 @@ public:
 	UPROPERTY(EditAnywhere)
 		int pointsValue = 0;
 
+	// Played on the player when an instant pick up is used
+	UPROPERTY(EditAnywhere, Category = "PickUp Properties")
+		ERunnerEffect collectEffect = ERunnerEffect::eNone;
+
+	// Can run on the default object, field orbs have no actor of their own
+	void PlayCollectEffect(class ABetaArcadeCharacter* Character) const;
+
 	/*UFUNCTION(BlueprintCallable)
 	virtual void UseFromHotbar(class ABetaArcadeCharacter* Character) {};*/
 
@@ -0,0 +1,289 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PickUpField.h"
+#include "PickUpBase.h"
+#include "BetaArcade.h"
+#include "BetaArcadeTrace.h"
+#include "BetaArcadeMemory.h"
+#include "BetaArcadeCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_CYCLE_STAT(TEXT("PickUp Field"), STAT_PickUpField, STATGROUP_BetaArcade);
+DECLARE_DWORD_COUNTER_STAT(TEXT("PickUp Field Orbs"), STAT_PickUpFieldOrbs, STATGROUP_BetaArcade);
+
+// A zero scale instance is culled, used for free slots
+static const FTransform HIDDEN_ORB = FTransform(FRotator::ZeroRotator, FVector(0.0f, 0.0f, -100000.0f), FVector::ZeroVector);
+
+APickUpField::APickUpField()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PostPhysics; // After the player has moved this frame
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	RootComponent->SetMobility(EComponentMobility::Movable);
+}
+
+void APickUpField::BeginPlay()
+{
+	Super::BeginPlay();
+
+	freeSlots.SetNum(orbTypes.Num());
+	orbMeshes.SetNum(orbTypes.Num());
+}
+
+void APickUpField::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_PickUpField);
+	BETAARCADE_ALLOCATION_SCOPE("PickUpField");
+
+	const FVector offset = GetActorLocation();
+	if (offset.SizeSquared() >= FMath::Square(rebaseDistance))
+	{
+		Rebase(offset);
+	}
+
+	ABetaArcadeCharacter* player = Cast<ABetaArcadeCharacter>(UGameplayStatics::GetPlayerCharacter(this, 0));
+	if (!player || orbX.Num() == 0)
+	{
+		SET_DWORD_STAT(STAT_PickUpFieldOrbs, orbX.Num());
+		return;
+	}
+
+	// Everything below works in field space, so only the player is transformed
+	const FTransform& fieldTransform = GetActorTransform();
+	const FVector playerLocation = fieldTransform.InverseTransformPosition(player->GetActorLocation());
+
+	if (player->isMagnetActive)
+	{
+		AttractOrbs(playerLocation, DeltaTime);
+	}
+
+	UCapsuleComponent* capsule = player->GetCapsuleComponent();
+	FindCollectedOrbs(playerLocation, capsule->GetScaledCapsuleRadius(), capsule->GetScaledCapsuleHalfHeight());
+
+	// Collected and passed orbs are rare, walk backwards so removal can swap
+	const FVector behind = fieldTransform.InverseTransformVector(mapDirection.GetSafeNormal());
+	for (int i = orbX.Num() - 1; i >= 0; --i)
+	{
+		if (collectedMask[i])
+		{
+			const FPickUpFieldType& type = orbTypes[orbType[i]];
+			if (type.pickUpClass)
+			{
+				// ItemAction only reads the pickup's defaults, so the default object stands in for the actor
+				player->SortPickUp(type.pickUpClass->GetDefaultObject<APickUpBase>());
+			}
+			orbsCollected++;
+			RemoveOrb(i);
+		}
+		else if ((orbX[i] - playerLocation.X) * behind.X + (orbY[i] - playerLocation.Y) * behind.Y > cullDistance)
+		{
+			RemoveOrb(i);
+		}
+	}
+
+	for (UInstancedStaticMeshComponent* meshes : dirtyMeshes)
+	{
+		meshes->MarkRenderStateDirty();
+	}
+	dirtyMeshes.Reset();
+
+	SET_DWORD_STAT(STAT_PickUpFieldOrbs, orbX.Num());
+}
+
+void APickUpField::Rebase(const FVector& offset)
+{
+	// Orbs keep their world position, only field space moves
+	const FVector localOffset = GetActorTransform().InverseTransformVector(offset);
+	SetActorLocation(FVector::ZeroVector, false, nullptr, ETeleportType::TeleportPhysics);
+
+	for (int i = 0; i < orbX.Num(); ++i)
+	{
+		orbX[i] += localOffset.X;
+		orbY[i] += localOffset.Y;
+		orbZ[i] += localOffset.Z;
+
+		UInstancedStaticMeshComponent* meshes = orbMeshes[orbType[i]];
+		const FTransform transform(FRotator::ZeroRotator, FVector(orbX[i], orbY[i], orbZ[i]), orbTypes[orbType[i]].meshScale);
+		meshes->UpdateInstanceTransform(orbInstance[i], transform, false, false, true);
+		dirtyMeshes.Add(meshes);
+	}
+}
+
+void APickUpField::AttractOrbs(const FVector& target, float DeltaTime)
+{
+	const int numOrbs = orbX.Num();
+	const float radiusSquared = magnetRadius * magnetRadius;
+	const float step = magnetSpeed * DeltaTime;
+
+	float* RESTRICT x = orbX.GetData();
+	float* RESTRICT y = orbY.GetData();
+	float* RESTRICT z = orbZ.GetData();
+
+	for (int i = 0; i < numOrbs; ++i)
+	{
+		const float dx = target.X - x[i];
+		const float dy = target.Y - y[i];
+		const float dz = target.Z - z[i];
+		const float distanceSquared = dx * dx + dy * dy + dz * dz;
+
+		// Orbs out of range get a scale of 0, keeps the loop free of branches
+		const float inRange = distanceSquared <= radiusSquared ? 1.0f : 0.0f;
+		const float scale = inRange * FMath::Min(step * FMath::InvSqrt(distanceSquared + KINDA_SMALL_NUMBER), 1.0f);
+
+		x[i] += dx * scale;
+		y[i] += dy * scale;
+		z[i] += dz * scale;
+	}
+
+	for (int i = 0; i < numOrbs; ++i)
+	{
+		const float dx = target.X - x[i];
+		const float dy = target.Y - y[i];
+		if (dx * dx + dy * dy <= radiusSquared)
+		{
+			UInstancedStaticMeshComponent* meshes = orbMeshes[orbType[i]];
+			const FTransform transform(FRotator::ZeroRotator, FVector(x[i], y[i], z[i]), orbTypes[orbType[i]].meshScale);
+			meshes->UpdateInstanceTransform(orbInstance[i], transform, false, false, true);
+			dirtyMeshes.Add(meshes);
+		}
+	}
+}
+
+void APickUpField::FindCollectedOrbs(const FVector& playerLocation, float capsuleRadius, float capsuleHalfHeight)
+{
+	const int numOrbs = orbX.Num();
+	collectedMask.SetNumUninitialized(numOrbs, false);
+
+	// Capsule against sphere: distance to the capsule's centre segment against the summed radii
+	const float reachSquared = FMath::Square(capsuleRadius + orbRadius);
+	const float segmentHalfLength = FMath::Max(capsuleHalfHeight - capsuleRadius, 0.0f);
+
+	const float* RESTRICT x = orbX.GetData();
+	const float* RESTRICT y = orbY.GetData();
+	const float* RESTRICT z = orbZ.GetData();
+	uint8* RESTRICT mask = collectedMask.GetData();
+
+	for (int i = 0; i < numOrbs; ++i)
+	{
+		const float dx = x[i] - playerLocation.X;
+		const float dy = y[i] - playerLocation.Y;
+		const float dz = FMath::Max(FMath::Abs(z[i] - playerLocation.Z) - segmentHalfLength, 0.0f);
+		mask[i] = (dx * dx + dy * dy + dz * dz) <= reachSquared ? 1 : 0;
+	}
+}
+
+int APickUpField::GetNumOrbsOfType(int typeIndex) const
+{
+	int count = 0;
+	for (uint8 type : orbType)
+	{
+		count += type == typeIndex ? 1 : 0;
+	}
+	return count;
+}
+
+int APickUpField::AddOrb(int typeIndex, FVector worldLocation)
+{
+	BETAARCADE_LLM_SCOPE(PickUps);
+
+	UInstancedStaticMeshComponent* meshes = GetOrCreateMeshes(typeIndex);
+	if (!meshes)
+	{
+		return INDEX_NONE;
+	}
+
+	const FVector location = GetActorTransform().InverseTransformPosition(worldLocation);
+	const FTransform transform(FRotator::ZeroRotator, location, orbTypes[typeIndex].meshScale);
+
+	int32 instance;
+	if (freeSlots[typeIndex].Num() > 0)
+	{
+		instance = freeSlots[typeIndex].Pop(false);
+		meshes->UpdateInstanceTransform(instance, transform, false, false, true);
+		dirtyMeshes.Add(meshes);
+	}
+	else
+	{
+		instance = meshes->AddInstance(transform);
+	}
+
+	orbX.Add(location.X);
+	orbY.Add(location.Y);
+	orbZ.Add(location.Z);
+	orbType.Add((uint8)typeIndex);
+	return orbInstance.Add(instance);
+}
+
+void APickUpField::AddOrbLine(int typeIndex, FVector worldStart, FVector worldDirection, int count, float spacing)
+{
+	const FVector step = worldDirection.GetSafeNormal() * spacing;
+	for (int i = 0; i < count; ++i)
+	{
+		AddOrb(typeIndex, worldStart + step * i);
+	}
+}
+
+void APickUpField::ClearOrbs()
+{
+	for (int i = orbX.Num() - 1; i >= 0; --i)
+	{
+		RemoveOrb(i);
+	}
+	for (UInstancedStaticMeshComponent* meshes : dirtyMeshes)
+	{
+		meshes->MarkRenderStateDirty();
+	}
+	dirtyMeshes.Reset();
+}
+
+void APickUpField::RemoveOrb(int index)
+{
+	// Removing from an ISM reorders it, so the slot is hidden and kept for the next orb
+	UInstancedStaticMeshComponent* meshes = orbMeshes[orbType[index]];
+	meshes->UpdateInstanceTransform(orbInstance[index], HIDDEN_ORB, false, false, true);
+	freeSlots[orbType[index]].Add(orbInstance[index]);
+	dirtyMeshes.Add(meshes);
+
+	orbX.RemoveAtSwap(index, 1, false);
+	orbY.RemoveAtSwap(index, 1, false);
+	orbZ.RemoveAtSwap(index, 1, false);
+	orbType.RemoveAtSwap(index, 1, false);
+	orbInstance.RemoveAtSwap(index, 1, false);
+}
+
+UInstancedStaticMeshComponent* APickUpField::GetOrCreateMeshes(int typeIndex)
+{
+	if (!orbTypes.IsValidIndex(typeIndex) || !orbTypes[typeIndex].mesh || typeIndex > MAX_uint8)
+	{
+		return nullptr;
+	}
+
+	// orbTypes may have been filled in after BeginPlay
+	if (orbMeshes.Num() < orbTypes.Num())
+	{
+		orbMeshes.SetNum(orbTypes.Num());
+		freeSlots.SetNum(orbTypes.Num());
+	}
+
+	if (!orbMeshes[typeIndex])
+	{
+		// Plain ISM rather than HISM, magnet orbs move every frame and a HISM would rebuild its tree each time
+		UInstancedStaticMeshComponent* meshes = NewObject<UInstancedStaticMeshComponent>(this);
+		meshes->SetStaticMesh(orbTypes[typeIndex].mesh);
+		meshes->SetMobility(EComponentMobility::Movable);
+		meshes->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		meshes->SetGenerateOverlapEvents(false);
+		meshes->SetCastShadow(false);
+		meshes->SetupAttachment(RootComponent);
+		meshes->RegisterComponent();
+		orbMeshes[typeIndex] = meshes;
+	}
+
+	return orbMeshes[typeIndex];
+}
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "PickUpField.generated.h"
+
+class UStaticMesh;
+class UInstancedStaticMeshComponent;
+
+USTRUCT(BlueprintType)
+struct FPickUpFieldType
+{
+	GENERATED_BODY()
+
+	// Its default object's ItemAction runs on collection, the same as the actor version
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PickUp Field")
+		TSubclassOf<class APickUpBase> pickUpClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PickUp Field")
+		UStaticMesh* mesh = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PickUp Field")
+		FVector meshScale = FVector::OneVector;
+};
+
+/**
+ * Light orbs and points pickups without an actor each. Orbs are kept as structure of arrays in this actor's
+ * space and drawn with one instanced mesh per type. The actor rides the track scroller and is put back at
+ * the origin every rebaseDistance so field space stays small. Collection is one distance test against the player capsule
+ * over all orbs, and the magnet pulls every orb in range in one pass.
+ */
+UCLASS()
+class BETAARCADE_API APickUpField : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	APickUpField();
+
+	virtual void BeginPlay() override;
+	virtual void Tick(float DeltaTime) override;
+
+	// Index into orbTypes for each kind of orb
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PickUp Field")
+		TArray<FPickUpFieldType> orbTypes;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PickUp Field")
+		float orbRadius = 40.0f;
+
+	// Orbs this far inside the magnet radius are pulled towards the player while isMagnetActive is set
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PickUp Field")
+		float magnetRadius = 1500.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PickUp Field")
+		float magnetSpeed = 6000.0f;
+
+	// Orbs further than this behind the player are dropped without being collected
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PickUp Field")
+		float cullDistance = 2000.0f;
+
+	// Direction the map travels in, used to tell which orbs are behind the player
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PickUp Field")
+		FVector mapDirection = { -1.0f, 0.0f, 0.0f };
+
+	// The track scroller carries the field along, once it is this far out the offset is folded back into the orbs
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PickUp Field")
+		float rebaseDistance = 100000.0f;
+
+	UFUNCTION(BlueprintCallable)
+		int AddOrb(int typeIndex, FVector worldLocation);
+
+	// A straight line of orbs, the usual layout on a tile
+	UFUNCTION(BlueprintCallable)
+		void AddOrbLine(int typeIndex, FVector worldStart, FVector worldDirection, int count, float spacing);
+
+	UFUNCTION(BlueprintCallable)
+		void ClearOrbs();
+
+	UFUNCTION(BlueprintCallable)
+		int GetNumOrbs() const { return orbX.Num(); }
+
+	// Walks every orb, for the census rather than gameplay
+	int GetNumOrbsOfType(int typeIndex) const;
+
+	UPROPERTY(BlueprintReadOnly, Category = "PickUp Field")
+		int orbsCollected = 0;
+
+private:
+
+	void Rebase(const FVector& offset);
+	void AttractOrbs(const FVector& target, float DeltaTime);
+	void FindCollectedOrbs(const FVector& playerLocation, float capsuleRadius, float capsuleHalfHeight);
+	void RemoveOrb(int index);
+	UInstancedStaticMeshComponent* GetOrCreateMeshes(int typeIndex);
+
+	// Structure of arrays, all in this actor's space
+	TArray<float> orbX;
+	TArray<float> orbY;
+	TArray<float> orbZ;
+	TArray<uint8> orbType;
+	TArray<int32> orbInstance;
+
+	// Scratch space for the collection pass, one flag per orb
+	TArray<uint8> collectedMask;
+
+	UPROPERTY()
+		TArray<UInstancedStaticMeshComponent*> orbMeshes;
+
+	// Hidden instances ready for reuse, per type
+	TArray<TArray<int32>> freeSlots;
+
+	TSet<UInstancedStaticMeshComponent*> dirtyMeshes;
+};
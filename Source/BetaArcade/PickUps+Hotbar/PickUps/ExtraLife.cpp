@@ -10,6 +10,7 @@
 AExtraLife::AExtraLife()
 {
 	PickUpID = 6;
+	collectEffect = ERunnerEffect::ePickUpLife;
 	pointsValue = 30;
 }
 
@@ -20,6 +21,7 @@ void AExtraLife::ItemAction(class ABetaArcadeCharacter* Character)
 	{
 		Character->AddPlayerLives(1);
 		Character->AddPointsToScore(pointsValue);
+		PlayCollectEffect(Character);
 		UE_LOG(LogTemp, Log, TEXT("Added life"));
 	}
 }
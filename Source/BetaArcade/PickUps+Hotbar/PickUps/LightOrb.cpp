@@ -7,6 +7,7 @@
 ALightOrb::ALightOrb()
 {
 	PickUpID = 8;
+	collectEffect = ERunnerEffect::ePickUpLight;
 	pointsValue = 20;
 }
 
@@ -16,6 +17,7 @@ void ALightOrb::ItemAction(class ABetaArcadeCharacter* Character)
 	if (Character && Character->GetLightAmount() < 100)
 	{
 		Character->AddLightAmount(10);
+		PlayCollectEffect(Character);
 
 		UE_LOG(LogTemp, Log, TEXT("Added light"));
 		/*Destroy();*/
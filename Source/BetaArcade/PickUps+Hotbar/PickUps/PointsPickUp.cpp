@@ -8,7 +8,8 @@
 APointsPickUp::APointsPickUp()
 {
 	PickUpID = 7;
-	pointsValue = rand() % 50 + 250;
+	collectEffect = ERunnerEffect::ePickUpPoints;
+	pointsValue = 250;
 }
 
 
@@ -16,7 +17,8 @@ void APointsPickUp::ItemAction(class ABetaArcadeCharacter* Character)
 {
 	if (Character != NULL)
 	{
-		Character->AddPointsToScore(pointsValue);
+		Character->AddPointsToScore(pointsValue + FMath::RandHelper(pointsRange));
+		PlayCollectEffect(Character);
 		
 		/*Destroy();*/
 	}
@@ -17,4 +17,8 @@ class BETAARCADE_API APointsPickUp : public APickUpBase
 		APointsPickUp();
 public:
 	virtual void ItemAction(class ABetaArcadeCharacter* Character) override;
+
+	// Rolled on every collection, field orbs share the default object so a value rolled once would never change
+	UPROPERTY(EditAnywhere)
+		int pointsRange = 50; // On top of pointsValue
 };
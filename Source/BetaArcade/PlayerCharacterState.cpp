@@ -1,6 +1,16 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "PlayerCharacterState.h"
+#include "BetaArcade.h"
+#include "TrackSpatialIndex.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "RenderCore.h"
 //#include "BetaArcadeCharacter.h"
 //
 //APlayerCharacterState* APlayerCharacterState::HandleInput(ABetaArcadeCharacter& player)
@@ -15,3 +25,255 @@
 //void APlayerCharacterState::Update(ABetaArcadeCharacter & player)
 //{
 //}
+
+// Survives RestartLevel, the controller itself is recreated with the level
+static int32 GAutoplayRunsCompleted = 0;
+
+void APlayerCharacterState::BeginPlay()
+{
+	Super::BeginPlay();
+
+	autoplay |= FParse::Param(FCommandLine::Get(), TEXT("autoplay"));
+	if (!autoplay || !IsLocalController())
+	{
+		return;
+	}
+
+	FParse::Value(FCommandLine::Get(), TEXT("autoplaydilation="), autoplayTimeDilation);
+	FParse::Value(FCommandLine::Get(), TEXT("autoplayseconds="), maxRunSeconds);
+
+	UGameplayStatics::SetGlobalTimeDilation(this, autoplayTimeDilation);
+	frameTimes.Reserve(1 << 17);
+
+	UE_LOG(LogBetaArcade, Display, TEXT("Autoplay run %d started, time dilation %.1f"), GAutoplayRunsCompleted + 1, autoplayTimeDilation);
+}
+
+void APlayerCharacterState::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// The level went away under us, a Game Over screen or travel, still record what we have
+	if (autoplay && !runFinished && IsLocalController())
+	{
+		FinishRun(TEXT("ended"));
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void APlayerCharacterState::PlayerTick(float DeltaTime)
+{
+	Super::PlayerTick(DeltaTime);
+
+	ABetaArcadeCharacter* player = Cast<ABetaArcadeCharacter>(GetPawn());
+	if (!autoplay || runFinished || !player)
+	{
+		return;
+	}
+
+	// Dilation multiplies the steps due each frame, lift the cap so none of the run is thrown away
+	player->SetMaxSimulationStepsPerFrame(0);
+
+	runSeconds += DeltaTime;
+	if (frameTimes.Num() < frameTimes.Max())
+	{
+		frameTimes.Add(FPlatformTime::ToMilliseconds(GGameThreadTime));
+	}
+
+	const int lives = player->GetPlayerLives();
+	if (lastLives >= 0 && lives < lastLives)
+	{
+		RecordDeath(player);
+	}
+	lastLives = lives;
+
+	if (lives <= 0)
+	{
+		FinishRun(TEXT("dead"));
+		return;
+	}
+	if (runSeconds >= maxRunSeconds)
+	{
+		FinishRun(TEXT("time"));
+		return;
+	}
+
+	DriveCharacter(player);
+}
+
+void APlayerCharacterState::DriveCharacter(ABetaArcadeCharacter* player)
+{
+	// Combat and swarms just want the right buttons, combat at a rate a player could keep up
+	if (player->characterState == CharacterState::State::Combat)
+	{
+		if (runSeconds >= nextCombatPressSeconds)
+		{
+			player->BetaJump();
+			nextCombatPressSeconds = runSeconds + 1.0f / FMath::Max(combatPressesPerSecond, 0.1f);
+		}
+		return;
+	}
+	if (player->currentSwarmKey.IsValid())
+	{
+		player->DodgeCheck(player->currentSwarmKey);
+	}
+	// LightMetreFull would set the power state every frame, over whatever pickup is active
+	if (player->GetLightAmount() >= 100 && !player->inCombat)
+	{
+		player->EnterCombat();
+	}
+
+	UTrackSpatialIndex* trackIndex = GetWorld()->GetSubsystem<UTrackSpatialIndex>();
+	if (!trackIndex)
+	{
+		return;
+	}
+
+	const float distance = player->GetSimulatedDistance();
+	const int32 obstacleKinds = (1 << (int32)ETrackEntryKind::eTile) | (1 << (int32)ETrackEntryKind::eObstacle);
+
+	// Nearest thing that needs an answer, basic tiles and corners have nothing to dodge
+	nearbyEntries.Reset();
+	trackIndex->Query(distance, distance + lookaheadDistance, TRACK_LANE_ANY, obstacleKinds, nearbyEntries);
+	const FTrackEntry* obstacle = nullptr;
+	for (const FTrackEntry& entry : nearbyEntries)
+	{
+		if (entry.tileType != ETileType::eBasic && entry.tileType != ETileType::eCorner
+			&& (!obstacle || entry.distance < obstacle->distance))
+		{
+			obstacle = &entry;
+		}
+	}
+
+	if (obstacle)
+	{
+		const float ahead = obstacle->distance - distance;
+		switch (obstacle->tileType)
+		{
+		case ETileType::eJump:
+			if (ahead <= jumpDistance)
+			{
+				player->BetaJump();
+			}
+			break;
+		case ETileType::eSlide:
+			if (ahead <= slideDistance)
+			{
+				player->StartSlide();
+			}
+			break;
+		case ETileType::eVault:
+			if (ahead <= vaultDistance)
+			{
+				if (player->canVault)
+				{
+					player->BetaJump();
+				}
+				else
+				{
+					player->StartVault();
+				}
+			}
+			break;
+		case ETileType::eCliff:
+			SteerToLane(player, 0); // Either side may drop away, the middle is always there
+			return;
+		default:
+			break;
+		}
+	}
+
+	// Nothing to dodge yet, go after the next pickup
+	FTrackEntry pickUp;
+	if (trackIndex->FindNext(distance, lookaheadDistance, TRACK_LANE_ANY, 1 << (int32)ETrackEntryKind::ePickUp, pickUp))
+	{
+		SteerToLane(player, pickUp.lane);
+	}
+	else
+	{
+		SteerToLane(player, 0);
+	}
+}
+
+void APlayerCharacterState::SteerToLane(ABetaArcadeCharacter* player, int lane)
+{
+	const float targetY = lane * TRACK_LANE_WIDTH;
+	const float offset = targetY - player->GetActorLocation().Y;
+	player->MoveRight(FMath::Abs(offset) > 20.0f ? FMath::Sign(offset) : 0.0f);
+}
+
+void APlayerCharacterState::RecordDeath(ABetaArcadeCharacter* player)
+{
+	ETileType cause = ETileType::eBasic;
+
+	// Blame the nearest obstacle the player has just reached
+	UTrackSpatialIndex* trackIndex = GetWorld()->GetSubsystem<UTrackSpatialIndex>();
+	if (trackIndex)
+	{
+		const float distance = player->GetSimulatedDistance();
+		const int32 obstacleKinds = (1 << (int32)ETrackEntryKind::eTile) | (1 << (int32)ETrackEntryKind::eObstacle);
+
+		nearbyEntries.Reset();
+		trackIndex->Query(distance - 1000.0f, distance + 200.0f, TRACK_LANE_ANY, obstacleKinds, nearbyEntries);
+
+		float nearest = MAX_flt;
+		for (const FTrackEntry& entry : nearbyEntries)
+		{
+			if (entry.tileType != ETileType::eBasic && entry.tileType != ETileType::eCorner && FMath::Abs(entry.distance - distance) < nearest)
+			{
+				nearest = FMath::Abs(entry.distance - distance);
+				cause = entry.tileType;
+			}
+		}
+	}
+
+	deathsByTile[(int)cause]++;
+}
+
+void APlayerCharacterState::FinishRun(const TCHAR* reason)
+{
+	runFinished = true;
+	GAutoplayRunsCompleted++;
+
+	ABetaArcadeCharacter* player = Cast<ABetaArcadeCharacter>(GetPawn());
+
+	TArray<float> sortedTimes = frameTimes;
+	sortedTimes.Sort();
+	auto percentile = [&sortedTimes](float fraction)
+	{
+		return sortedTimes.Num() > 0 ? sortedTimes[FMath::Min((int)(fraction * sortedTimes.Num()), sortedTimes.Num() - 1)] : 0.0f;
+	};
+
+	FString deaths;
+	const UEnum* tileEnum = StaticEnum<ETileType>();
+	for (int i = 0; i < NUM_TILE_TYPES; ++i)
+	{
+		deaths += FString::Printf(TEXT("%s\"%s\":%d"), i > 0 ? TEXT(",") : TEXT(""), *tileEnum->GetNameStringByIndex(i), deathsByTile[i]);
+	}
+
+	const FString summary = FString::Printf(
+		TEXT("{\"run\":%d,\"end\":\"%s\",\"gameSeconds\":%.2f,\"timeDilation\":%.2f,\"distance\":%.1f,\"score\":%d,\"lives\":%d,")
+		TEXT("\"simSteps\":%llu,\"droppedSimSeconds\":%.3f,\"deaths\":{%s},\"frames\":%d,\"frameMs\":{\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,\"max\":%.3f}}\n"),
+		GAutoplayRunsCompleted, reason, runSeconds, autoplayTimeDilation,
+		player ? player->GetSimulatedDistance() : 0.0f, player ? player->GetPlayerScore() : 0, player ? player->GetPlayerLives() : 0,
+		player ? player->GetSimulationStepCount() : 0ull, player ? player->GetDroppedSimulationSeconds() : 0.0, *deaths,
+		sortedTimes.Num(), percentile(0.5f), percentile(0.9f), percentile(0.99f), sortedTimes.Num() > 0 ? sortedTimes.Last() : 0.0f);
+
+	const FString outputPath = FPaths::ProjectSavedDir() / TEXT("Autoplay/Summary.json");
+	FFileHelper::SaveStringToFile(summary, *outputPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+	UE_LOG(LogBetaArcade, Display, TEXT("Autoplay %s"), *summary.TrimEnd());
+
+	if (!GetWorld() || GetWorld()->bIsTearingDown)
+	{
+		return;
+	}
+
+	int32 runs = 1;
+	FParse::Value(FCommandLine::Get(), TEXT("autoplayruns="), runs);
+	if (GAutoplayRunsCompleted < runs)
+	{
+		RestartLevel();
+	}
+	else if (FParse::Param(FCommandLine::Get(), TEXT("autoplay")) && !GIsAutomationTesting) // Tests quit once they have a result
+	{
+		FGenericPlatformMisc::RequestExit(false);
+	}
+}
@@ -5,11 +5,20 @@
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
 #include "BetaArcadeCharacter.h"
+#include "TrackGenerator.h"
+#include "TrackSpatialIndex.h"
 #include "PlayerCharacterState.generated.h"
 //
 //class ABetaArcadeCharacter;
 /**
- * 
+ * Player controller. With autoplay on (or -autoplay on the command line) it plays the run itself from what
+ * the track index says is coming, for balancing runs in a -nullrhi session. Each run writes a summary line to
+ * Saved/Autoplay/Summary.json.
+ *
+ * -autoplay               turn the bot on
+ * -autoplaydilation=8     global time dilation while the bot plays
+ * -autoplayruns=10        restart the level this many times, then quit
+ * -autoplayseconds=600    end a run after this much game time even if the player is still alive
  */
 UCLASS()
 class BETAARCADE_API APlayerCharacterState : public APlayerController
@@ -23,4 +32,50 @@ class BETAARCADE_API APlayerCharacterState : public APlayerController
 //	virtual APlayerCharacterState* HandleInput(ABetaArcadeCharacter& player);
 //	virtual void Enter(ABetaArcadeCharacter& player);
 //	virtual void Update(ABetaArcadeCharacter& player);
+
+public:
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void PlayerTick(float DeltaTime) override;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Autoplay)
+		bool autoplay = false;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Autoplay)
+		float autoplayTimeDilation = 8.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Autoplay)
+		float maxRunSeconds = 600.0f;
+
+	// How far ahead of an obstacle the bot reacts, in track distance
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Autoplay)
+		float jumpDistance = 350.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Autoplay)
+		float slideDistance = 300.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Autoplay)
+		float vaultDistance = 250.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Autoplay)
+		float lookaheadDistance = 2000.0f;
+
+	// Jump presses in combat, in game time so the bonus it earns doesn't depend on frame rate or time dilation
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Autoplay)
+		float combatPressesPerSecond = 6.0f;
+
+private:
+
+	void DriveCharacter(ABetaArcadeCharacter* player);
+	void SteerToLane(ABetaArcadeCharacter* player, int lane);
+	void RecordDeath(ABetaArcadeCharacter* player);
+	void FinishRun(const TCHAR* reason);
+
+	float runSeconds = 0.0f;
+	float nextCombatPressSeconds = 0.0f;
+	int lastLives = -1;
+	int deathsByTile[NUM_TILE_TYPES] = {};
+	bool runFinished = false;
+
+	// Reused for track index queries
+	TArray<FTrackEntry> nearbyEntries;
+
+	// Game thread milliseconds, one per frame, preallocated so recording doesn't allocate during the run
+	TArray<float> frameTimes;
 };
@@ -0,0 +1,32 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "PooledActor.generated.h"
+
+UINTERFACE(BlueprintType)
+class UPooledActor : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Reset hook for actors handed out by the tile pool.
+ * BeginPlay only runs once for a pooled actor, so anything a tile sets up on spawn (pickups, obstacles) should be redone here.
+ */
+class BETAARCADE_API IPooledActor
+{
+	GENERATED_BODY()
+
+public:
+
+	// Called after the actor has been moved to its new transform and made visible again
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = Pool)
+		void OnAcquiredFromPool();
+
+	// Called before the actor is hidden and parked, undo anything that changed during play
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = Pool)
+		void OnReturnedToPool();
+};
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "RunnerAnimInstance.h"
+#include "BetaArcadeGameMode.h"
+#include "BetaArcadeTrace.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Player Anim Gather (game thread)"), STAT_PlayerAnimGather, STATGROUP_BetaArcade);
+DECLARE_CYCLE_STAT(TEXT("Player Anim Update (game thread)"), STAT_PlayerAnimUpdateGameThread, STATGROUP_BetaArcade);
+DECLARE_CYCLE_STAT(TEXT("Player Anim Update (worker)"), STAT_PlayerAnimUpdateWorker, STATGROUP_BetaArcade);
+
+void FRunnerAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
+{
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_PlayerAnimGather);
+
+	Super::PreUpdate(InAnimInstance, DeltaSeconds);
+
+	const URunnerAnimInstance* animInstance = CastChecked<URunnerAnimInstance>(InAnimInstance);
+	referenceRunSpeed = FMath::Max(animInstance->referenceRunSpeed, 1.0f);
+	blendSpeed = animInstance->blendSpeed;
+	maxLeanYaw = FMath::Max(animInstance->maxLeanYaw, 1.0f);
+
+	const ABetaArcadeCharacter* player = Cast<ABetaArcadeCharacter>(animInstance->TryGetPawnOwner());
+	if (!player)
+	{
+		return; // Editor preview, leave everything at rest
+	}
+
+	characterState = player->GetCharacterState();
+	inCombat = player->inCombat;
+	isFalling = player->GetCharacterMovement()->IsFalling();
+	yawOffset = FRotator::NormalizeAxis(player->GetActorRotation().Yaw - player->currentPlayerRotation.Yaw);
+
+	const ABetaArcadeGameMode* gameMode = player->GetWorld()->GetAuthGameMode<ABetaArcadeGameMode>();
+	mapSpeed = gameMode ? gameMode->GetMapVelocity().Size() : 0.0f;
+}
+
+void FRunnerAnimInstanceProxy::Update(float DeltaSeconds)
+{
+	// Runs on the game thread when multi threaded animation update is off, the split shows which
+	TRACE_CPUPROFILER_EVENT_SCOPE(PlayerAnimUpdate);
+	FScopeCycleCounter cycleCounter(IsInGameThread() ? GET_STATID(STAT_PlayerAnimUpdateGameThread) : GET_STATID(STAT_PlayerAnimUpdateWorker));
+
+	Super::Update(DeltaSeconds);
+
+	runSpeed = mapSpeed;
+	runPlayRate = mapSpeed / referenceRunSpeed;
+	isInAir = isFalling;
+	lean = FMath::FInterpTo(lean, FMath::Clamp(yawOffset / maxLeanYaw, -1.0f, 1.0f), DeltaSeconds, blendSpeed);
+
+	jumpAlpha = FMath::FInterpTo(jumpAlpha, characterState == CharacterState::State::Jumping ? 1.0f : 0.0f, DeltaSeconds, blendSpeed);
+	vaultAlpha = FMath::FInterpTo(vaultAlpha, characterState == CharacterState::State::Vaulting ? 1.0f : 0.0f, DeltaSeconds, blendSpeed);
+	slideAlpha = FMath::FInterpTo(slideAlpha, characterState == CharacterState::State::Sliding ? 1.0f : 0.0f, DeltaSeconds, blendSpeed);
+	combatAlpha = FMath::FInterpTo(combatAlpha, inCombat ? 1.0f : 0.0f, DeltaSeconds, blendSpeed);
+	swarmAlpha = FMath::FInterpTo(swarmAlpha, characterState == CharacterState::State::Swarm ? 1.0f : 0.0f, DeltaSeconds, blendSpeed);
+}
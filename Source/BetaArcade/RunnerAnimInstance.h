@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "BetaArcadeCharacter.h"
+#include "RunnerAnimInstance.generated.h"
+
+/**
+ * Player blend parameters. PreUpdate copies what it needs off the character on the game thread,
+ * Update works the parameters out on an animation worker thread.
+ */
+USTRUCT(BlueprintType)
+struct BETAARCADE_API FRunnerAnimInstanceProxy : public FAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+	FRunnerAnimInstanceProxy() {}
+	FRunnerAnimInstanceProxy(UAnimInstance* InAnimInstance) : FAnimInstanceProxy(InAnimInstance) {}
+
+	virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+	virtual void Update(float DeltaSeconds) override;
+
+	// Read by the anim graph through the instance's proxy property
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Locomotion)
+		TEnumAsByte<CharacterState::State> characterState;
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Locomotion)
+		float runSpeed = 0.0f; // The map scrolls past the player, so this is the map speed
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Locomotion)
+		float runPlayRate = 1.0f;
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Locomotion)
+		float lean = 0.0f; // -1 leaning left to 1 leaning right
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Locomotion)
+		bool isInAir = false;
+
+	// 0 to 1 weights that ease in and out over blendSpeed
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Locomotion)
+		float jumpAlpha = 0.0f;
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Locomotion)
+		float vaultAlpha = 0.0f;
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Locomotion)
+		float slideAlpha = 0.0f;
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Combat)
+		float combatAlpha = 0.0f;
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Combat)
+		float swarmAlpha = 0.0f;
+
+private:
+
+	// Game thread copies, only touched in PreUpdate and Update
+	float mapSpeed = 0.0f;
+	float referenceRunSpeed = 1.0f;
+	float blendSpeed = 0.0f;
+	float yawOffset = 0.0f;
+	float maxLeanYaw = 1.0f;
+	bool isFalling = false;
+	bool inCombat = false;
+};
+
+/**
+ * Native parent for the player anim Blueprint. Nothing here reads the character off the game thread,
+ * so with Use Multi Threaded Animation Update on, the whole update runs on a worker.
+ */
+UCLASS(Transient, Blueprintable)
+class BETAARCADE_API URunnerAnimInstance : public UAnimInstance
+{
+	GENERATED_BODY()
+
+	friend struct FRunnerAnimInstanceProxy;
+
+public:
+
+	// Map speed the run animation was authored at, the play rate scales from it
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Locomotion)
+		float referenceRunSpeed = 4000.0f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Locomotion)
+		float blendSpeed = 10.0f;
+	// Yaw away from the run direction that counts as a full lean, lane running turns the player up to 50
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Locomotion)
+		float maxLeanYaw = 50.0f;
+
+protected:
+
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override { return &proxy; }
+	virtual void DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy) override {}
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = Locomotion, meta = (AllowPrivateAccess = "true"))
+		FRunnerAnimInstanceProxy proxy;
+};
@@ -0,0 +1,197 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "RunnerCensus.h"
+#include "BetaArcade.h"
+#include "BetaArcadeGameMode.h"
+#include "IslandManagerComponent.h"
+#include "Monster.h"
+#include "Swarm.h"
+#include "PickUps+Hotbar/PickUpBase.h"
+#include "PickUps+Hotbar/PickUpField.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+CSV_DEFINE_CATEGORY(BetaArcade, true);
+
+static TAutoConsoleVariable<int32> CVarCensusCsvFrames(
+	TEXT("BetaArcade.CensusCsvFrames"),
+	30,
+	TEXT("How often the runner census is written to a CSV profile capture, in frames"));
+
+int64 FRunnerCensus::GetPoolBytes() const
+{
+	int64 bytes = 0;
+	for (const FActorPoolCensus& pool : pools)
+	{
+		bytes += pool.bytes;
+	}
+	return bytes;
+}
+
+void URunnerCensus::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	for (int id = 0; id < MAX_CENSUS_PICKUP_ID; ++id)
+	{
+		pickUpStatNames[id] = *FString::Printf(TEXT("PickUp%d"), id);
+	}
+}
+
+void URunnerCensus::Tick(float DeltaTime)
+{
+#if CSV_PROFILER
+	if (!FCsvProfiler::Get()->IsCapturing())
+	{
+		return;
+	}
+
+	if (++framesSinceCsv >= FMath::Max(CVarCensusCsvFrames.GetValueOnGameThread(), 1))
+	{
+		framesSinceCsv = 0;
+		WriteCsvStats();
+	}
+#endif
+}
+
+ETickableTickType URunnerCensus::GetTickableTickType() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool URunnerCensus::IsTickable() const
+{
+	const UWorld* world = GetWorld();
+	return world && world->IsGameWorld();
+}
+
+TStatId URunnerCensus::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(URunnerCensus, STATGROUP_Tickables);
+}
+
+void URunnerCensus::TakeCensus(FRunnerCensus& outCensus) const
+{
+	UWorld* world = GetWorld();
+
+	if (const ABetaArcadeGameMode* gameMode = world->GetAuthGameMode<ABetaArcadeGameMode>())
+	{
+		outCensus.currentTiles = gameMode->GetNumCurrentTiles();
+		if (const UIslandManagerComponent* islandManager = gameMode->GetIslandManager())
+		{
+			outCensus.islands = islandManager->GetNumLiveIslands();
+			outCensus.islandBytes = islandManager->GetLiveIslandBytes();
+		}
+
+		const APickUpField* field = gameMode->GetPickUpField();
+		for (int type = 0; field && type < field->orbTypes.Num(); ++type)
+		{
+			const TSubclassOf<APickUpBase> pickUpClass = field->orbTypes[type].pickUpClass;
+			const int id = pickUpClass ? pickUpClass.GetDefaultObject()->PickUpID : 0;
+			const int orbs = field->GetNumOrbsOfType(type);
+
+			outCensus.pickUpsByID[FMath::Clamp(id, 0, MAX_CENSUS_PICKUP_ID - 1)] += orbs;
+			outCensus.fieldOrbs += orbs;
+		}
+	}
+
+	// Parked actors are hidden, only what is in play counts
+	for (TActorIterator<AActor> it(world); it; ++it)
+	{
+		AActor* actor = *it;
+		outCensus.actors++;
+		if (actor->IsHidden())
+		{
+			continue;
+		}
+
+		if (const APickUpBase* pickUp = Cast<APickUpBase>(actor))
+		{
+			outCensus.pickUpsByID[FMath::Clamp(pickUp->PickUpID, 0, MAX_CENSUS_PICKUP_ID - 1)]++;
+		}
+		else if (actor->IsA<ASwarm>())
+		{
+			outCensus.swarms++;
+		}
+		else if (actor->IsA<AMonster>())
+		{
+			outCensus.monsters++;
+		}
+	}
+
+	if (const UTilePoolSubsystem* pool = world->GetSubsystem<UTilePoolSubsystem>())
+	{
+		pool->GetCensus(outCensus.pools);
+	}
+}
+
+void URunnerCensus::LogCensus() const
+{
+	FRunnerCensus census;
+	TakeCensus(census);
+
+	UE_LOG(LogBetaArcade, Display, TEXT("Census: %d actors, %d current tiles, %d islands (%lld bytes), %d swarms, %d monsters, %d field orbs"),
+		census.actors, census.currentTiles, census.islands, census.islandBytes, census.swarms, census.monsters, census.fieldOrbs);
+
+	for (int id = 0; id < MAX_CENSUS_PICKUP_ID; ++id)
+	{
+		if (census.pickUpsByID[id] > 0)
+		{
+			UE_LOG(LogBetaArcade, Display, TEXT("  PickUpID %d: %d"), id, census.pickUpsByID[id]);
+		}
+	}
+
+	for (const FActorPoolCensus& pool : census.pools)
+	{
+		UE_LOG(LogBetaArcade, Display, TEXT("  Pool %s: %d live, %d free, high water %d, %lld bytes"),
+			*GetNameSafe(pool.actorClass), pool.stats.liveCount, pool.stats.freeCount, pool.stats.highWater, pool.bytes);
+	}
+	UE_LOG(LogBetaArcade, Display, TEXT("  Pools total: %lld bytes"), census.GetPoolBytes());
+}
+
+void URunnerCensus::WriteCsvStats()
+{
+#if CSV_PROFILER
+	FRunnerCensus census;
+	TakeCensus(census);
+
+	int pooledLive = 0;
+	int pooledFree = 0;
+	for (const FActorPoolCensus& pool : census.pools)
+	{
+		pooledLive += pool.stats.liveCount;
+		pooledFree += pool.stats.freeCount;
+	}
+
+	CSV_CUSTOM_STAT(BetaArcade, Actors, census.actors, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(BetaArcade, CurrentTiles, census.currentTiles, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(BetaArcade, Islands, census.islands, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(BetaArcade, IslandKB, (float)(census.islandBytes / 1024.0), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(BetaArcade, Swarms, census.swarms, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(BetaArcade, FieldOrbs, census.fieldOrbs, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(BetaArcade, PooledLive, pooledLive, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(BetaArcade, PooledFree, pooledFree, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(BetaArcade, PoolKB, (float)(census.GetPoolBytes() / 1024.0), ECsvCustomStatOp::Set);
+
+	for (int id = 0; id < MAX_CENSUS_PICKUP_ID; ++id)
+	{
+		if (census.pickUpsByID[id] > 0)
+		{
+			FCsvProfiler::RecordCustomStat(pickUpStatNames[id], CSV_CATEGORY_INDEX(BetaArcade), census.pickUpsByID[id], ECsvCustomStatOp::Set);
+		}
+	}
+#endif
+}
+
+static FAutoConsoleCommandWithWorld CensusCommand(
+	TEXT("BetaArcade.Census"),
+	TEXT("Logs live tiles, islands, pickups by PickUpID, swarms and tile pool occupancy and bytes"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* world)
+	{
+		if (URunnerCensus* census = world ? world->GetSubsystem<URunnerCensus>() : nullptr)
+		{
+			census->LogCensus();
+		}
+	}));
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "TilePoolSubsystem.h"
+#include "RunnerCensus.generated.h"
+
+// PickUpIDs run from 1 up, anything past this is counted in the last slot
+static const int MAX_CENSUS_PICKUP_ID = 16;
+
+// What is alive in the run right now
+struct FRunnerCensus
+{
+	int currentTiles = 0;
+	int islands = 0;
+	int64 islandBytes = 0;
+	int pickUpsByID[MAX_CENSUS_PICKUP_ID] = {};
+	int fieldOrbs = 0; // Also counted in pickUpsByID
+	int swarms = 0;
+	int monsters = 0;
+	int actors = 0;
+	TArray<FActorPoolCensus> pools;
+
+	int64 GetPoolBytes() const;
+};
+
+/**
+ * Counts tiles, islands, pickups by PickUpID, swarms and pool occupancy. BetaArcade.Census logs it,
+ * and while a CSV profile is being captured (csvprofile start, or -csvCaptureFrames) it is written as
+ * BetaArcade CSV stats every BetaArcade.CensusCsvFrames frames for soak runs.
+ */
+UCLASS()
+class BETAARCADE_API URunnerCensus : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+	void TakeCensus(FRunnerCensus& outCensus) const;
+	void LogCensus() const;
+
+private:
+
+	void WriteCsvStats();
+
+	FName pickUpStatNames[MAX_CENSUS_PICKUP_ID];
+	int framesSinceCsv = 0;
+};
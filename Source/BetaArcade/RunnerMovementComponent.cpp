@@ -0,0 +1,220 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "RunnerMovementComponent.h"
+#include "BetaArcadeTrace.h"
+#include "GameFramework/Character.h"
+
+DECLARE_CYCLE_STAT(TEXT("Runner Lane Movement"), STAT_RunnerLaneMovement, STATGROUP_BetaArcade);
+
+// Lane input sent to the server with each move, left and right as the two custom flags
+class FSavedMove_Runner : public FSavedMove_Character
+{
+public:
+
+	typedef FSavedMove_Character Super;
+
+	virtual void Clear() override
+	{
+		Super::Clear();
+		laneInput = 0.0f;
+	}
+
+	virtual uint8 GetCompressedFlags() const override
+	{
+		uint8 flags = Super::GetCompressedFlags();
+		if (laneInput < 0.0f)
+		{
+			flags |= FLAG_Custom_0;
+		}
+		else if (laneInput > 0.0f)
+		{
+			flags |= FLAG_Custom_1;
+		}
+		return flags;
+	}
+
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override
+	{
+		if (laneInput != static_cast<const FSavedMove_Runner*>(NewMove.Get())->laneInput)
+		{
+			return false;
+		}
+		return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+	}
+
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override
+	{
+		Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+		if (const URunnerMovementComponent* movement = Cast<URunnerMovementComponent>(C->GetCharacterMovement()))
+		{
+			laneInput = movement->laneInput;
+		}
+	}
+
+	virtual void PrepMoveFor(ACharacter* C) override
+	{
+		Super::PrepMoveFor(C);
+
+		if (URunnerMovementComponent* movement = Cast<URunnerMovementComponent>(C->GetCharacterMovement()))
+		{
+			movement->laneInput = laneInput;
+		}
+	}
+
+	float laneInput = 0.0f;
+};
+
+class FNetworkPredictionData_Client_Runner : public FNetworkPredictionData_Client_Character
+{
+public:
+
+	typedef FNetworkPredictionData_Client_Character Super;
+
+	FNetworkPredictionData_Client_Runner(const UCharacterMovementComponent& ClientMovement) : Super(ClientMovement) {}
+
+	virtual FSavedMovePtr AllocateNewMove() override { return FSavedMovePtr(new FSavedMove_Runner()); }
+};
+
+void URunnerMovementComponent::SetLaneInput(float input, const FRotator& runRotation)
+{
+	laneInput = FMath::Sign(input);
+	laneRunRotation = runRotation;
+}
+
+bool URunnerMovementComponent::IsMovingOnGround() const
+{
+	return Super::IsMovingOnGround() || (IsLaneRunning() && UpdatedComponent);
+}
+
+float URunnerMovementComponent::GetMaxSpeed() const
+{
+	return IsLaneRunning() ? MaxWalkSpeed : Super::GetMaxSpeed();
+}
+
+float URunnerMovementComponent::GetMaxBrakingDeceleration() const
+{
+	return IsLaneRunning() ? BrakingDecelerationWalking : Super::GetMaxBrakingDeceleration();
+}
+
+void URunnerMovementComponent::SetDefaultMovementMode()
+{
+	Super::SetDefaultMovementMode();
+
+	if (useLaneMovement && MovementMode == MOVE_Walking)
+	{
+		SetMovementMode(MOVE_Custom, (uint8)ERunnerMovementMode::eLane);
+	}
+}
+
+void URunnerMovementComponent::SetPostLandedPhysics(const FHitResult& Hit)
+{
+	Super::SetPostLandedPhysics(Hit);
+
+	if (useLaneMovement && MovementMode == MOVE_Walking)
+	{
+		SetMovementMode(MOVE_Custom, (uint8)ERunnerMovementMode::eLane);
+	}
+}
+
+void URunnerMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
+{
+	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+
+	if (IsLaneRunning())
+	{
+		// Start from a known floor
+		Velocity.Z = 0.0f;
+		floorCheckTimeLeft = 0.0f;
+	}
+}
+
+void URunnerMovementComponent::PhysicsRotation(float DeltaTime)
+{
+	// Lane running turns the character as part of its own move
+	if (!IsLaneRunning())
+	{
+		Super::PhysicsRotation(DeltaTime);
+	}
+}
+
+void URunnerMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	laneInput = (Flags & FSavedMove_Character::FLAG_Custom_1) ? 1.0f : ((Flags & FSavedMove_Character::FLAG_Custom_0) ? -1.0f : 0.0f);
+}
+
+FNetworkPredictionData_Client* URunnerMovementComponent::GetPredictionData_Client() const
+{
+	if (!ClientPredictionData)
+	{
+		URunnerMovementComponent* mutableThis = const_cast<URunnerMovementComponent*>(this);
+		mutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Runner(*this);
+	}
+	return ClientPredictionData;
+}
+
+void URunnerMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
+{
+	if (CustomMovementMode == (uint8)ERunnerMovementMode::eLane)
+	{
+		PhysLane(deltaTime, Iterations);
+		return;
+	}
+
+	Super::PhysCustom(deltaTime, Iterations);
+}
+
+void URunnerMovementComponent::PhysLane(float deltaTime, int32 Iterations)
+{
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_RunnerLaneMovement);
+
+	if (deltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+
+	// Forward run, the walking acceleration and friction on the run axis only
+	Acceleration.Y = 0.0f;
+	Acceleration.Z = 0.0f;
+	Velocity.Z = 0.0f;
+	CalcVelocity(deltaTime, GroundFriction, false, GetMaxBrakingDeceleration());
+
+	// Lane change, stopping at the edge of the track. Never pulls the player in from outside it, only stops them going further out
+	const float y = UpdatedComponent->GetComponentLocation().Y;
+	const float targetY = FMath::Clamp(y + laneInput * laneChangeSpeed * deltaTime, FMath::Min(y, -maxLateralOffset), FMath::Max(y, maxLateralOffset));
+	Velocity.Y = (targetY - y) / deltaTime;
+
+	// Lean into the lane change
+	const FRotator targetRotation = laneRunRotation + FRotator(0.0f, laneInput * laneLeanYaw, 0.0f);
+	const FRotator rotation = FMath::RInterpTo(UpdatedComponent->GetComponentRotation(), targetRotation, deltaTime, leanRotationSpeed);
+
+	const FVector delta = Velocity * deltaTime;
+	FHitResult hit(1.0f);
+	SafeMoveUpdatedComponent(delta, rotation.Quaternion(), true, hit);
+	if (hit.IsValidBlockingHit())
+	{
+		HandleImpact(hit, deltaTime, delta);
+		SlideAlongSurface(delta, 1.0f - hit.Time, hit.Normal, hit, true);
+		floorCheckTimeLeft = 0.0f; // Ran into something, make sure there is still a floor
+	}
+
+	// Tiles are flat, so the floor only needs checking now and then to notice gaps and keep the base
+	floorCheckTimeLeft -= deltaTime;
+	if (floorCheckTimeLeft > 0.0f)
+	{
+		return;
+	}
+	floorCheckTimeLeft = floorCheckInterval;
+
+	FindFloor(UpdatedComponent->GetComponentLocation(), CurrentFloor, false);
+	if (!CurrentFloor.IsWalkableFloor())
+	{
+		SetMovementMode(MOVE_Falling);
+		return;
+	}
+
+	AdjustFloorHeight();
+	SetBaseFromFloor(CurrentFloor);
+}
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "RunnerMovementComponent.generated.h"
+
+UENUM(BlueprintType)
+enum class ERunnerMovementMode : uint8
+{
+	eLane	UMETA(DisplayName = "Lane"),
+};
+
+/**
+ * Character movement with a lane running mode for the flat track. The forward run keeps the walking
+ * acceleration and friction, sideways movement is a lane change velocity clamped to the track, and the
+ * lean goes into the same move, so there is one sweep and one transform update per tick.
+ * The floor is only looked for every floorCheckInterval or after a blocked move, the mode drops to
+ * falling when it runs out and comes back on landing.
+ *
+ * Lane input travels in the saved moves as two compressed flags, so the mode predicts on clients.
+ */
+UCLASS()
+class BETAARCADE_API URunnerMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+	friend class FSavedMove_Runner;
+
+public:
+
+	// Only the sign matters, like the old fixed sideways step. runRotation is the way the track faces
+	void SetLaneInput(float input, const FRotator& runRotation);
+
+	UFUNCTION(BlueprintCallable)
+		bool IsLaneRunning() const { return MovementMode == MOVE_Custom && CustomMovementMode == (uint8)ERunnerMovementMode::eLane; }
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Lane Running")
+		bool useLaneMovement = true;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Lane Running")
+		float laneChangeSpeed = 840.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Lane Running")
+		float maxLateralOffset = 240.0f; // Either side of the middle of the track
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Lane Running")
+		float laneLeanYaw = 50.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Lane Running")
+		float leanRotationSpeed = 30.0f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Lane Running")
+		float floorCheckInterval = 0.1f;
+
+	virtual bool IsMovingOnGround() const override;
+	virtual float GetMaxSpeed() const override;
+	virtual float GetMaxBrakingDeceleration() const override;
+	virtual void SetDefaultMovementMode() override;
+	virtual void PhysicsRotation(float DeltaTime) override;
+	virtual class FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+protected:
+
+	virtual void PhysCustom(float deltaTime, int32 Iterations) override;
+	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
+	virtual void SetPostLandedPhysics(const FHitResult& Hit) override;
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+
+	void PhysLane(float deltaTime, int32 Iterations);
+
+	float laneInput = 0.0f; // -1, 0 or 1
+	FRotator laneRunRotation = FRotator::ZeroRotator;
+	float floorCheckTimeLeft = 0.0f;
+};
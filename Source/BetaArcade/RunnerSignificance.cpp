@@ -0,0 +1,366 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "RunnerSignificance.h"
+#include "BetaArcade.h"
+#include "BetaArcadeBenchmark.h"
+#include "BetaArcadeTrace.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "NiagaraComponent.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "SignificanceManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Runner Significance"), STAT_RunnerSignificance, STATGROUP_BetaArcade);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Significance High"), STAT_SignificanceHigh, STATGROUP_BetaArcade);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Significance Off"), STAT_SignificanceOff, STATGROUP_BetaArcade);
+
+static TAutoConsoleVariable<int32> CVarRunnerSignificance(
+	TEXT("BetaArcade.Significance"),
+	1,
+	TEXT("Scale monster, swarm, island and pickup update rates by significance, 0 runs everything at full rate"));
+
+namespace
+{
+	// Distances from the view where significance starts dropping, and where it reaches 0
+	struct FSignificanceRange
+	{
+		float fullDetail;
+		float cull;
+	};
+	const FSignificanceRange categoryRanges[NUM_RUNNER_TICK_CATEGORIES] =
+	{
+		{ 2000.0f, 12000.0f },	// Islands, purely decorative
+		{ 1000.0f, 6000.0f },	// Vault boxes
+		{ 1500.0f, 6000.0f },	// Monster, 2000 to 5000 behind the player
+		{ 1500.0f, 8000.0f },	// Swarms
+		{ 1500.0f, 8000.0f },	// Pickups
+	};
+
+	const TCHAR* categoryTags[NUM_RUNNER_TICK_CATEGORIES] =
+	{
+		TEXT("Island"),
+		TEXT("VaultBox"),
+		TEXT("Monster"),
+		TEXT("Swarm"),
+		TEXT("PickUp"),
+	};
+
+	// Per level, High to Off
+	const float levelTickIntervals[NUM_RUNNER_SIGNIFICANCE_LEVELS] = { 0.0f, 0.05f, 0.2f, 0.5f };
+	const float levelAnimIntervals[NUM_RUNNER_SIGNIFICANCE_LEVELS] = { 0.0f, 1.0f / 30.0f, 0.1f, 0.25f };
+	const EParticleSignificanceLevel levelParticleSignificance[NUM_RUNNER_SIGNIFICANCE_LEVELS] =
+	{
+		EParticleSignificanceLevel::Low,
+		EParticleSignificanceLevel::Medium,
+		EParticleSignificanceLevel::High,
+		EParticleSignificanceLevel::Critical,
+	};
+
+	ERunnerSignificanceLevel GetLevel(float significance)
+	{
+		if (significance >= 0.75f)
+		{
+			return ERunnerSignificanceLevel::eHigh;
+		}
+		if (significance >= 0.4f)
+		{
+			return ERunnerSignificanceLevel::eMedium;
+		}
+		return significance >= 0.1f ? ERunnerSignificanceLevel::eLow : ERunnerSignificanceLevel::eOff;
+	}
+}
+
+void URunnerSignificance::Deinitialize()
+{
+	actors.Empty();
+	effectInstigators.Empty();
+
+	Super::Deinitialize();
+}
+
+void URunnerSignificance::Tick(float DeltaTime)
+{
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_RunnerSignificance);
+
+	UWorld* world = GetWorld();
+	USignificanceManager* significanceManager = USignificanceManager::Get(world);
+	if (!significanceManager)
+	{
+		return;
+	}
+
+	const bool enabled = CVarRunnerSignificance.GetValueOnGameThread() > 0;
+	if (!enabled)
+	{
+		if (wasEnabled)
+		{
+			for (TPair<AActor*, FSignificantActor>& entry : actors)
+			{
+				ApplyLevel(entry.Key, entry.Value, ERunnerSignificanceLevel::eHigh);
+			}
+			wasEnabled = false;
+		}
+		return;
+	}
+	wasEnabled = true;
+
+	APlayerController* playerController = UGameplayStatics::GetPlayerController(world, 0);
+	if (!playerController)
+	{
+		return;
+	}
+
+	FVector viewLocation;
+	FRotator viewRotation;
+	playerController->GetPlayerViewPoint(viewLocation, viewRotation);
+	const FTransform viewpoint(viewRotation, viewLocation);
+	significanceManager->Update(TArrayView<const FTransform>(&viewpoint, 1));
+
+	SET_DWORD_STAT(STAT_SignificanceHigh, numAtLevel[(int)ERunnerSignificanceLevel::eHigh]);
+	SET_DWORD_STAT(STAT_SignificanceOff, numAtLevel[(int)ERunnerSignificanceLevel::eOff]);
+}
+
+ETickableTickType URunnerSignificance::GetTickableTickType() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool URunnerSignificance::IsTickable() const
+{
+	const UWorld* world = GetWorld();
+	return world && world->IsGameWorld();
+}
+
+TStatId URunnerSignificance::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(URunnerSignificance, STATGROUP_Tickables);
+}
+
+void URunnerSignificance::Register(AActor* actor, ERunnerTickCategory category)
+{
+	USignificanceManager* significanceManager = USignificanceManager::Get(GetWorld());
+	if (!significanceManager || actors.Contains(actor))
+	{
+		return;
+	}
+
+	FSignificantActor& info = actors.Add(actor);
+	info.category = category;
+	numAtLevel[(int)info.level]++;
+
+	// Let the engine drop the animation rate of meshes off screen or small on screen as well
+	TInlineComponentArray<USkeletalMeshComponent*> meshes(actor);
+	for (USkeletalMeshComponent* mesh : meshes)
+	{
+		mesh->bEnableUpdateRateOptimizations = true;
+	}
+
+	significanceManager->RegisterObject(actor, FName(categoryTags[(int)category]),
+		[this, category](USignificanceManager::FManagedObjectInfo* objectInfo, const FTransform& viewpoint)
+		{
+			return ScoreActor(CastChecked<AActor>(objectInfo->GetObject()), category, viewpoint);
+		},
+		USignificanceManager::EPostSignificanceType::Sequential,
+		[this](USignificanceManager::FManagedObjectInfo* objectInfo, float oldSignificance, float significance, bool bFinal)
+		{
+			AActor* significantActor = CastChecked<AActor>(objectInfo->GetObject());
+			if (FSignificantActor* entry = actors.Find(significantActor))
+			{
+				ApplyLevel(significantActor, *entry, GetLevel(significance));
+			}
+		});
+}
+
+void URunnerSignificance::Unregister(AActor* actor)
+{
+	FSignificantActor info;
+	if (!actors.RemoveAndCopyValue(actor, info))
+	{
+		return;
+	}
+	numAtLevel[(int)info.level]--;
+
+	// Anything it paused plays on at full rate until it goes back to the pool
+	for (UNiagaraComponent* effect : info.effects)
+	{
+		effect->SetPaused(false);
+		effectInstigators.Remove(effect);
+	}
+
+	if (USignificanceManager* significanceManager = USignificanceManager::Get(GetWorld()))
+	{
+		significanceManager->UnregisterObject(actor);
+	}
+}
+
+ERunnerSignificanceLevel URunnerSignificance::GetActorLevel(const AActor* actor) const
+{
+	const FSignificantActor* info = actors.Find(const_cast<AActor*>(actor));
+	return info ? info->level : ERunnerSignificanceLevel::eHigh;
+}
+
+void URunnerSignificance::SetEffectInstigator(UNiagaraComponent* effect, AActor* instigator)
+{
+	if (!effect)
+	{
+		return;
+	}
+
+	// A capped effect is restarted for its next instigator while still playing for the last one
+	AActor* previous = nullptr;
+	if (effectInstigators.RemoveAndCopyValue(effect, previous))
+	{
+		if (FSignificantActor* previousInfo = actors.Find(previous))
+		{
+			previousInfo->effects.RemoveSwap(effect);
+		}
+		effect->SetPaused(false);
+	}
+
+	FSignificantActor* info = instigator ? actors.Find(instigator) : nullptr;
+	if (!info)
+	{
+		return;
+	}
+
+	info->effects.Add(effect);
+	effectInstigators.Add(effect, instigator);
+	effect->SetPaused(info->level == ERunnerSignificanceLevel::eOff);
+}
+
+int URunnerSignificance::CountPosesTicked() const
+{
+	int posesTicked = 0;
+	for (const TPair<AActor*, FSignificantActor>& entry : actors)
+	{
+		TInlineComponentArray<USkeletalMeshComponent*> meshes(entry.Key);
+		for (const USkeletalMeshComponent* mesh : meshes)
+		{
+			posesTicked += mesh->PoseTickedThisFrame() ? 1 : 0;
+		}
+	}
+	return posesTicked;
+}
+
+float URunnerSignificance::ScoreActor(const AActor* actor, ERunnerTickCategory category, const FTransform& viewpoint) const
+{
+	const FSignificanceRange& range = categoryRanges[(int)category];
+	const float distance = FVector::Dist(actor->GetActorLocation(), viewpoint.GetLocation());
+	float significance = 1.0f - FMath::Clamp((distance - range.fullDetail) / (range.cull - range.fullDetail), 0.0f, 1.0f);
+
+	// Out of sight counts for half, the monster spends most of the run behind the camera
+	if (!actor->WasRecentlyRendered(0.25f))
+	{
+		significance *= 0.5f;
+	}
+	return significance;
+}
+
+void URunnerSignificance::ApplyLevel(AActor* actor, FSignificantActor& info, ERunnerSignificanceLevel level)
+{
+	if (info.level == level)
+	{
+		return;
+	}
+	numAtLevel[(int)info.level]--;
+	numAtLevel[(int)level]++;
+	info.level = level;
+
+	const int levelIndex = (int)level;
+	if (URunnerTickManager* tickManager = GetWorld()->GetSubsystem<URunnerTickManager>())
+	{
+		tickManager->SetActorInterval(actor, info.category, levelTickIntervals[levelIndex]); // Blueprints with an Event Tick
+	}
+
+	TInlineComponentArray<UActorComponent*> components(actor);
+	for (UActorComponent* component : components)
+	{
+		if (USkeletalMeshComponent* mesh = Cast<USkeletalMeshComponent>(component))
+		{
+			mesh->SetComponentTickInterval(levelAnimIntervals[levelIndex]);
+		}
+		else if (UParticleSystemComponent* particles = Cast<UParticleSystemComponent>(component))
+		{
+			particles->SetRequiredSignificance(levelParticleSignificance[levelIndex]);
+		}
+		else if (UNiagaraComponent* niagara = Cast<UNiagaraComponent>(component))
+		{
+			niagara->SetPaused(level == ERunnerSignificanceLevel::eOff);
+		}
+	}
+
+	for (UNiagaraComponent* effect : info.effects)
+	{
+		effect->SetPaused(level == ERunnerSignificanceLevel::eOff);
+	}
+}
+
+namespace
+{
+	/**
+	 * Runs the current track with significance off and then on, and compares game thread time
+	 * and skeletal mesh pose ticks. Run it in a session that is playing, -autoplay keeps
+	 * the track populated without anyone at the keyboard.
+	 */
+	class FSignificanceBenchmark : public FTwoPhaseBenchmark
+	{
+	public:
+
+		FSignificanceBenchmark(UWorld* inWorld, int inFrames)
+			: FTwoPhaseBenchmark(TEXT("SignificanceBenchmark"), inWorld, inFrames)
+		{
+			previousSetting = CVarRunnerSignificance.GetValueOnGameThread();
+		}
+
+	private:
+
+		virtual void BeginPhase(int phase) override
+		{
+			CVarRunnerSignificance.AsVariable()->Set(phase, ECVF_SetByCode);
+		}
+
+		virtual void SampleFrame(int phase) override
+		{
+			const URunnerSignificance* significance = GetWorld()->GetSubsystem<URunnerSignificance>();
+			posesTicked[phase] += significance ? significance->CountPosesTicked() : 0;
+		}
+
+		virtual void Restore() override
+		{
+			CVarRunnerSignificance.AsVariable()->Set(previousSetting, ECVF_SetByCode);
+		}
+
+		virtual void Finish() override
+		{
+			const double offMs = gameThreadMs[0] / frames;
+			const double onMs = gameThreadMs[1] / frames;
+			const double offPoses = (double)posesTicked[0] / frames;
+			const double onPoses = (double)posesTicked[1] / frames;
+			UE_LOG(LogBetaArcade, Display, TEXT("SignificanceBenchmark off=%.3fms on=%.3fms saved=%.3fms, poses ticked %.1f -> %.1f per frame"),
+				offMs, onMs, offMs - onMs, offPoses, onPoses);
+
+			AppendBenchmarkCsv(TEXT("Significance.csv"), TEXT("frames,offMs,onMs,savedMs,offPosesTicked,onPosesTicked"),
+				FString::Printf(TEXT("%d,%.4f,%.4f,%.4f,%.2f,%.2f\n"), frames, offMs, onMs, offMs - onMs, offPoses, onPoses));
+		}
+
+		int previousSetting = 1;
+		int64 posesTicked[2] = { 0, 0 };
+	};
+}
+
+static FAutoConsoleCommandWithWorldAndArgs SignificanceBenchmarkCommand(
+	TEXT("BetaArcade.SignificanceBenchmark"),
+	TEXT("BetaArcade.SignificanceBenchmark [frames=600] - runs the track with significance off then on, appends to Saved/Benchmarks/Significance.csv"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& args, UWorld* world)
+	{
+		if (FTwoPhaseBenchmark::IsRunning())
+		{
+			return;
+		}
+
+		const int frames = args.Num() > 0 ? FCString::Atoi(*args[0]) : 600;
+		FTwoPhaseBenchmark::Start(MakeUnique<FSignificanceBenchmark>(world, frames));
+	}));
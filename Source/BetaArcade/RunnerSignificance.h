@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "RunnerTickManager.h"
+#include "RunnerSignificance.generated.h"
+
+class UNiagaraComponent;
+
+// High ticks, animates and shows effects at full rate, Off is out of sight and far away
+UENUM(BlueprintType)
+enum class ERunnerSignificanceLevel : uint8
+{
+	eHigh,
+	eMedium,
+	eLow,
+	eOff,
+};
+static const int NUM_RUNNER_SIGNIFICANCE_LEVELS = 4;
+
+/**
+ * Scores the monster, swarms, islands and pickups with the significance manager, by distance from the
+ * player's view and whether they were on screen, and scales each one's update rate to match:
+ * the actor tick interval through URunnerTickManager, skeletal mesh tick interval on top of the engine's update
+ * rate optimisations, and particle and Niagara detail, including pooled effects played on an actor's behalf.
+ * Levels are only applied when they change.
+ * BetaArcade.Significance 0 puts everything back to full rate, BetaArcade.SignificanceBenchmark compares the two.
+ */
+UCLASS()
+class BETAARCADE_API URunnerSignificance : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+	// URunnerTickManager::RegisterActor and UnregisterActor call these
+	void Register(AActor* actor, ERunnerTickCategory category);
+	void Unregister(AActor* actor);
+
+	int GetNumAtLevel(ERunnerSignificanceLevel level) const { return numAtLevel[(int)level]; }
+
+	// High for actors that aren't registered
+	ERunnerSignificanceLevel GetActorLevel(const AActor* actor) const;
+
+	// Pooled effects belong to UEffectPoolSubsystem, not the actor that played them. Set while one plays so it
+	// follows the instigator's level, null when it goes back to the pool
+	void SetEffectInstigator(UNiagaraComponent* effect, AActor* instigator);
+
+	// Skeletal meshes on registered actors that ticked their pose this frame
+	int CountPosesTicked() const;
+
+private:
+
+	struct FSignificantActor
+	{
+		ERunnerTickCategory category;
+		ERunnerSignificanceLevel level = ERunnerSignificanceLevel::eHigh;
+		TArray<UNiagaraComponent*, TInlineAllocator<2>> effects; // Pooled, playing for this actor
+	};
+
+	float ScoreActor(const AActor* actor, ERunnerTickCategory category, const FTransform& viewpoint) const;
+	void ApplyLevel(AActor* actor, FSignificantActor& info, ERunnerSignificanceLevel level);
+
+	TMap<AActor*, FSignificantActor> actors;
+	TMap<UNiagaraComponent*, AActor*> effectInstigators;
+	int numAtLevel[NUM_RUNNER_SIGNIFICANCE_LEVELS] = {};
+	bool wasEnabled = true;
+};
@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "RunnerSimulation.h"
+
+void FFixedStepClock::SetRate(float stepsPerSecond)
+{
+	stepSeconds = 1.0f / FMath::Max(stepsPerSecond, 1.0f);
+	accumulator = 0.0f;
+}
+
+int FFixedStepClock::Advance(float DeltaTime)
+{
+	accumulator += FMath::Max(DeltaTime, 0.0f);
+
+	int steps = 0;
+	while (accumulator >= stepSeconds && (maxStepsPerFrame <= 0 || steps < maxStepsPerFrame))
+	{
+		accumulator -= stepSeconds;
+		steps++;
+	}
+
+	// Dropped time, the game slows down rather than stalling on catch up steps
+	if (accumulator >= stepSeconds)
+	{
+		const float kept = FMath::Fmod(accumulator, stepSeconds);
+		droppedSeconds += accumulator - kept;
+		accumulator = kept;
+	}
+
+	stepCount += steps;
+	return steps;
+}
+
+FRunnerSimState FRunnerSimState::Lerp(const FRunnerSimState& from, const FRunnerSimState& to, float alpha)
+{
+	FRunnerSimState state;
+	state.distance = FMath::Lerp(from.distance, to.distance, alpha);
+	state.monsterGap = FMath::Lerp(from.monsterGap, to.monsterGap, alpha);
+	return state;
+}
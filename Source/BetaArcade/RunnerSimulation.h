@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RunnerSimulation.generated.h"
+
+/**
+ * Turns variable frame times into a whole number of fixed simulation steps.
+ * Whatever is left over is carried to the next frame and used as the interpolation alpha.
+ */
+struct BETAARCADE_API FFixedStepClock
+{
+	void SetRate(float stepsPerSecond);
+
+	// How many steps are due this frame, capped so a long hitch can't spiral
+	int Advance(float DeltaTime);
+
+	float GetStepSeconds() const { return stepSeconds; }
+
+	// How far between the last two steps the frame is, for presentation
+	float GetAlpha() const { return accumulator / stepSeconds; }
+
+	uint64 GetStepCount() const { return stepCount; }
+
+	// Time thrown away by the cap, the simulation is this far behind the world clock
+	double GetDroppedSeconds() const { return droppedSeconds; }
+
+	// 0 or less is no cap, every due step runs however long the frame was
+	int maxStepsPerFrame = 8;
+
+private:
+
+	float stepSeconds = 1.0f / 60.0f;
+	float accumulator = 0.0f;
+	uint64 stepCount = 0;
+	double droppedSeconds = 0.0;
+};
+
+// Continuous gameplay values, kept for the last two steps so they can be drawn between them
+USTRUCT(BlueprintType)
+struct FRunnerSimState
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = Simulation)
+		float distance = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = Simulation)
+		float monsterGap = 0.0f;
+
+	static FRunnerSimState Lerp(const FRunnerSimState& from, const FRunnerSimState& to, float alpha);
+};
@@ -0,0 +1,268 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "RunnerTickManager.h"
+#include "BetaArcade.h"
+#include "BetaArcadeBenchmark.h"
+#include "RunnerSignificance.h"
+#include "FloatingIsland.h"
+#include "VaultBox.h"
+#include "PickUps+Hotbar/PickUps/LightOrb.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+
+void URunnerTickManager::Deinitialize()
+{
+	for (FRunnerTickList& list : lists)
+	{
+		list.actors.Empty();
+		list.actorIntervals.Empty();
+	}
+
+	Super::Deinitialize();
+}
+
+void URunnerTickManager::RegisterActor(AActor* actor, ERunnerTickCategory category)
+{
+	UWorld* world = actor ? actor->GetWorld() : nullptr;
+	if (!world)
+	{
+		return;
+	}
+
+	if (URunnerTickManager* tickManager = world->GetSubsystem<URunnerTickManager>())
+	{
+		tickManager->Register(actor, category);
+	}
+	// Second, significance sets the actor's interval through the tick manager
+	if (URunnerSignificance* significance = world->GetSubsystem<URunnerSignificance>())
+	{
+		significance->Register(actor, category);
+	}
+}
+
+void URunnerTickManager::UnregisterActor(AActor* actor, ERunnerTickCategory category)
+{
+	UWorld* world = actor ? actor->GetWorld() : nullptr;
+	if (!world)
+	{
+		return;
+	}
+
+	if (URunnerSignificance* significance = world->GetSubsystem<URunnerSignificance>())
+	{
+		significance->Unregister(actor);
+	}
+	if (URunnerTickManager* tickManager = world->GetSubsystem<URunnerTickManager>())
+	{
+		tickManager->Unregister(actor, category);
+	}
+}
+
+void URunnerTickManager::Register(AActor* actor, ERunnerTickCategory category)
+{
+	if (!actor || !actor->GetClass()->ImplementsInterface(URunnerTickable::StaticClass()))
+	{
+		return;
+	}
+
+	FRunnerTickList& list = lists[(int)category];
+	int index = list.actors.Find(actor);
+	if (index == INDEX_NONE)
+	{
+		index = list.actors.Add(actor);
+		list.actorIntervals.Add(0.0f);
+	}
+	ApplyActorTick(actor, list, index);
+}
+
+void URunnerTickManager::Unregister(AActor* actor, ERunnerTickCategory category)
+{
+	FRunnerTickList& list = lists[(int)category];
+	const int index = list.actors.Find(actor);
+	if (index != INDEX_NONE)
+	{
+		list.actors.RemoveAtSwap(index, 1, false);
+		list.actorIntervals.RemoveAtSwap(index, 1, false);
+	}
+}
+
+void URunnerTickManager::SetActorInterval(AActor* actor, ERunnerTickCategory category, float interval)
+{
+	FRunnerTickList& list = lists[(int)category];
+	const int index = list.actors.Find(actor);
+	if (index != INDEX_NONE)
+	{
+		list.actorIntervals[index] = interval;
+		ApplyActorTick(actor, list, index);
+	}
+}
+
+void URunnerTickManager::SetCategoryInterval(ERunnerTickCategory category, float interval)
+{
+	FRunnerTickList& list = lists[(int)category];
+	list.interval = interval;
+	for (int i = 0; i < list.actors.Num(); ++i)
+	{
+		ApplyActorTick(list.actors[i], list, i);
+	}
+}
+
+int URunnerTickManager::GetNumRegistered(ERunnerTickCategory category) const
+{
+	return lists[(int)category].actors.Num();
+}
+
+int URunnerTickManager::GetNumTicking() const
+{
+	int ticking = 0;
+	for (const FRunnerTickList& list : lists)
+	{
+		for (const AActor* actor : list.actors)
+		{
+			ticking += actor->IsActorTickEnabled() ? 1 : 0;
+		}
+	}
+	return ticking;
+}
+
+void URunnerTickManager::SetAggregationEnabled(bool enabled)
+{
+	aggregationEnabled = enabled;
+	for (const FRunnerTickList& list : lists)
+	{
+		for (int i = 0; i < list.actors.Num(); ++i)
+		{
+			ApplyActorTick(list.actors[i], list, i);
+		}
+	}
+}
+
+bool URunnerTickManager::NeedsActorTick(const AActor* actor)
+{
+	if (!actor->GetClass()->ImplementsInterface(URunnerTickable::StaticClass()))
+	{
+		return true;
+	}
+
+	const UWorld* world = actor->GetWorld();
+	const URunnerTickManager* tickManager = world ? world->GetSubsystem<URunnerTickManager>() : nullptr;
+	if (!tickManager || !tickManager->aggregationEnabled)
+	{
+		return true;
+	}
+
+	// The native Tick is empty, only a Blueprint Event Tick gives the actor anything to do
+	static const FName receiveTickName(TEXT("ReceiveTick"));
+	if (!actor->GetClass()->IsFunctionImplementedInScript(receiveTickName))
+	{
+		return false;
+	}
+
+	for (const FRunnerTickList& list : tickManager->lists)
+	{
+		if (list.interval < 0.0f && list.actors.Contains(actor))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void URunnerTickManager::ApplyActorTick(AActor* actor, const FRunnerTickList& list, int index) const
+{
+	if (!actor->PrimaryActorTick.bCanEverTick)
+	{
+		return;
+	}
+
+	actor->SetActorTickInterval(aggregationEnabled ? FMath::Max3(list.interval, list.actorIntervals[index], 0.0f) : 0.0f);
+
+	// Parked in the tile pool, it sorts the tick out when the actor comes back
+	if (!actor->IsHidden())
+	{
+		actor->SetActorTickEnabled(NeedsActorTick(actor));
+	}
+}
+
+namespace
+{
+	/**
+	 * Spawns a field of islands, vault boxes and light orbs, then measures game thread time with every
+	 * actor ticking and with the tick manager switching off the ticks that have nothing to do.
+	 */
+	class FRunnerTickBenchmark : public FTwoPhaseBenchmark
+	{
+	public:
+
+		FRunnerTickBenchmark(UWorld* inWorld, int numActors, int inFrames)
+			: FTwoPhaseBenchmark(TEXT("TickBenchmark"), inWorld, inFrames)
+		{
+			FActorSpawnParameters spawnParams;
+			spawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+			UClass* classes[] = { AFloatingIsland::StaticClass(), AVaultBox::StaticClass(), ALightOrb::StaticClass() };
+			for (int i = 0; i < numActors; ++i)
+			{
+				const FVector location(i * 100.0f, 0.0f, -50000.0f);
+				spawnedActors.Add(inWorld->SpawnActor<AActor>(classes[i % UE_ARRAY_COUNT(classes)], location, FRotator::ZeroRotator, spawnParams));
+			}
+		}
+
+	private:
+
+		// Every actor ticking first, then the tick manager switching off the ones with nothing to do
+		virtual void BeginPhase(int phase) override
+		{
+			if (URunnerTickManager* tickManager = GetWorld()->GetSubsystem<URunnerTickManager>())
+			{
+				tickManager->SetAggregationEnabled(phase == 1);
+			}
+		}
+
+		virtual void Restore() override
+		{
+			// Gone with the world if it went away
+			if (!GetWorld())
+			{
+				return;
+			}
+
+			for (AActor* actor : spawnedActors)
+			{
+				if (actor)
+				{
+					actor->Destroy();
+				}
+			}
+		}
+
+		virtual void Finish() override
+		{
+			const double perActorMs = gameThreadMs[0] / frames;
+			const double aggregatedMs = gameThreadMs[1] / frames;
+			UE_LOG(LogBetaArcade, Display, TEXT("TickBenchmark actors=%d per-actor=%.3fms aggregated=%.3fms saved=%.3fms"),
+				spawnedActors.Num(), perActorMs, aggregatedMs, perActorMs - aggregatedMs);
+
+			AppendBenchmarkCsv(TEXT("TickAggregation.csv"), TEXT("actors,frames,perActorMs,aggregatedMs,savedMs"),
+				FString::Printf(TEXT("%d,%d,%.4f,%.4f,%.4f\n"), spawnedActors.Num(), frames, perActorMs, aggregatedMs, perActorMs - aggregatedMs));
+		}
+
+		TArray<AActor*> spawnedActors;
+	};
+}
+
+static FAutoConsoleCommandWithWorldAndArgs TickBenchmarkCommand(
+	TEXT("BetaArcade.TickBenchmark"),
+	TEXT("BetaArcade.TickBenchmark [actors=600] [frames=300] - compares per actor ticks against the runner tick manager, appends to Saved/Benchmarks/TickAggregation.csv"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& args, UWorld* world)
+	{
+		if (FTwoPhaseBenchmark::IsRunning())
+		{
+			return;
+		}
+
+		const int numActors = args.Num() > 0 ? FCString::Atoi(*args[0]) : 600;
+		const int frames = args.Num() > 1 ? FCString::Atoi(*args[1]) : 300;
+		FTwoPhaseBenchmark::Start(MakeUnique<FRunnerTickBenchmark>(world, FMath::Max(numActors, 1), frames));
+	}));
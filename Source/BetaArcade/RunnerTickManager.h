@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/Interface.h"
+#include "RunnerTickManager.generated.h"
+
+UENUM(BlueprintType)
+enum class ERunnerTickCategory : uint8
+{
+	eIsland,
+	eVaultBox,
+	eMonster,
+	eSwarm,
+	ePickUp,
+};
+static const int NUM_RUNNER_TICK_CATEGORIES = 5;
+
+UINTERFACE(meta = (CannotImplementInterfaceInBlueprint))
+class URunnerTickable : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Marks actors whose tick URunnerTickManager owns. Register them with URunnerTickManager::RegisterActor
+ * from BeginPlay and UnregisterActor from EndPlay.
+ */
+class BETAARCADE_API IRunnerTickable
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Owns the tick of islands, vault boxes, the monster, swarms and pickups. None of them do native work per frame,
+ * so their tick functions are switched off unless the Blueprint has an Event Tick, and the ones that stay on
+ * run at the category interval, or the actor's own interval from URunnerSignificance if that is longer.
+ */
+UCLASS()
+class BETAARCADE_API URunnerTickManager : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	// Registers with the world's tick manager and with URunnerSignificance
+	static void RegisterActor(AActor* actor, ERunnerTickCategory category);
+	static void UnregisterActor(AActor* actor, ERunnerTickCategory category);
+
+	void Register(AActor* actor, ERunnerTickCategory category);
+	void Unregister(AActor* actor, ERunnerTickCategory category);
+
+	// 0 leaves the category on every frame, below 0 switches its ticks off entirely
+	UFUNCTION(BlueprintCallable)
+		void SetCategoryInterval(ERunnerTickCategory category, float interval);
+
+	// Per actor on top of the category interval, URunnerSignificance slows down actors that matter less
+	void SetActorInterval(AActor* actor, ERunnerTickCategory category, float interval);
+
+	UFUNCTION(BlueprintCallable)
+		int GetNumRegistered(ERunnerTickCategory category) const;
+
+	// Registered actors whose tick function is still on
+	int GetNumTicking() const;
+
+	// Off puts every registered actor back on its own tick function every frame, used to compare the two
+	void SetAggregationEnabled(bool enabled);
+	bool IsAggregationEnabled() const { return aggregationEnabled; }
+
+	// Whether the actor still needs its own tick function, the tile pool asks this when reactivating actors
+	static bool NeedsActorTick(const AActor* actor);
+
+private:
+
+	struct FRunnerTickList
+	{
+		TArray<AActor*> actors;
+		TArray<float> actorIntervals; // Parallel to actors
+		float interval = 0.0f;
+	};
+
+	void ApplyActorTick(AActor* actor, const FRunnerTickList& list, int index) const;
+
+	FRunnerTickList lists[NUM_RUNNER_TICK_CATEGORIES];
+	bool aggregationEnabled = true;
+};
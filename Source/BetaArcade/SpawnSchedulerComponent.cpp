@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpawnSchedulerComponent.h"
+#include "BetaArcade.h"
+#include "BetaArcadeTrace.h"
+#include "BetaArcadeMemory.h"
+#include "TilePoolSubsystem.h"
+#include "TrackScrollerComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/PlatformTime.h"
+
+DECLARE_CYCLE_STAT(TEXT("Spawn Scheduler"), STAT_SpawnScheduler, STATGROUP_BetaArcade);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Spawn Queue Length"), STAT_SpawnQueueLength, STATGROUP_BetaArcade);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Spawn Budget Overruns"), STAT_SpawnBudgetOverruns, STATGROUP_BetaArcade);
+
+USpawnSchedulerComponent::USpawnSchedulerComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickGroup = TG_PrePhysics;
+}
+
+void USpawnSchedulerComponent::QueueSpawn(FSpawnRequest request, float distanceToPlayer, float speed)
+{
+	request.deadline = distanceToPlayer / FMath::Max(speed, 1.0f);
+	request.queuedTime = GetWorld()->GetTimeSeconds(); // Game time, the track only moves when the world does
+	request.scrolledOffsetWhenQueued = GetScrolledOffset();
+	request.pendingActor = nullptr;
+
+	// Keep the queue sorted by deadline, the list is short
+	const double dueTime = request.queuedTime + request.deadline;
+	int index = 0;
+	while (index < queue.Num() && queue[index].queuedTime + queue[index].deadline <= dueTime)
+	{
+		index++;
+	}
+	queue.Insert(request, index);
+}
+
+void USpawnSchedulerComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_SpawnScheduler);
+	BETAARCADE_ALLOCATION_SCOPE("SpawnScheduler");
+
+	// The deadlines are in game time so pauses and time dilation move them with the track,
+	// only the frame budget is real time
+	const double gameTime = GetWorld()->GetTimeSeconds();
+	const double startTime = FPlatformTime::Seconds();
+	const double budgetSeconds = budgetMs / 1000.0;
+	bool overBudget = false;
+
+	while (queue.Num() > 0)
+	{
+		const float timeLeft = (float)(queue[0].queuedTime + queue[0].deadline - gameTime);
+		const bool urgent = timeLeft < urgentSeconds;
+
+		if (FPlatformTime::Seconds() - startTime >= budgetSeconds)
+		{
+			if (!urgent)
+			{
+				break;
+			}
+			overBudget = true;
+		}
+
+		if (ProcessRequest(queue[0]))
+		{
+			queue.RemoveAt(0, 1, false);
+		}
+	}
+
+	if (overBudget)
+	{
+		budgetOverruns++;
+		INC_DWORD_STAT(STAT_SpawnBudgetOverruns);
+	}
+	SET_DWORD_STAT(STAT_SpawnQueueLength, queue.Num());
+}
+
+bool USpawnSchedulerComponent::ProcessRequest(FSpawnRequest& request)
+{
+	BETAARCADE_LLM_SCOPE_BYTAG(request.requestType == ESpawnRequestType::eIsland ? EBetaArcadeLLMTag::Islands : EBetaArcadeLLMTag::Tiles);
+
+	// The track has moved on since the request was made
+	FTransform transform = request.transform;
+	transform.AddToTranslation(GetScrolledOffset() - request.scrolledOffsetWhenQueued);
+
+	if (request.pendingActor)
+	{
+		// Second step of a pool miss, run construction scripts and BeginPlay
+		request.pendingActor->FinishSpawning(transform);
+		OnSpawnFinished.Broadcast(request.pendingActor, request);
+		return true;
+	}
+
+	UTilePoolSubsystem* pool = GetWorld()->GetSubsystem<UTilePoolSubsystem>();
+	if (!pool || !request.actorClass)
+	{
+		return true; // Nothing we can do, drop it
+	}
+
+	bool needsFinishSpawning = false;
+	AActor* actor = pool->AcquireDeferred(request.actorClass, transform, GetOwner(), needsFinishSpawning);
+	if (!actor)
+	{
+		return true;
+	}
+
+	if (needsFinishSpawning)
+	{
+		request.pendingActor = actor;
+		return false;
+	}
+
+	OnSpawnFinished.Broadcast(actor, request);
+	return true;
+}
+
+FVector USpawnSchedulerComponent::GetScrolledOffset() const
+{
+	const UTrackScrollerComponent* scroller = GetOwner() ? GetOwner()->FindComponentByClass<UTrackScrollerComponent>() : nullptr;
+	return scroller && scroller->IsActive() ? scroller->scrolledOffset : FVector::ZeroVector;
+}
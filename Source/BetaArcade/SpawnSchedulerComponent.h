@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "TrackGenerator.h"
+#include "SpawnSchedulerComponent.generated.h"
+
+UENUM(BlueprintType)
+enum class ESpawnRequestType : uint8
+{
+	eTile,
+	eCorner,
+	eIsland,
+};
+
+USTRUCT(BlueprintType)
+struct FSpawnRequest
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = Spawning)
+		ESpawnRequestType requestType = ESpawnRequestType::eTile;
+	UPROPERTY(BlueprintReadOnly, Category = Spawning)
+		ETileType tileType = ETileType::eBasic;
+	UPROPERTY()
+		UClass* actorClass = nullptr;
+	UPROPERTY(BlueprintReadOnly, Category = Spawning)
+		FTransform transform;
+
+	// Seconds until the player reaches the spawn point, when it was queued
+	float deadline = 0.0f;
+	double queuedTime = 0.0; // World time seconds
+	FVector scrolledOffsetWhenQueued = FVector::ZeroVector;
+
+	// Set once the actor has been spawned deferred and is waiting for FinishSpawning
+	UPROPERTY()
+		AActor* pendingActor = nullptr;
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnSpawnRequestFinished, AActor*, const FSpawnRequest&);
+
+/**
+ * Queues tile, corner and island spawns and works through them under a per frame millisecond budget.
+ * Pool misses are spawned deferred and finished in a separate step, so one spawn can straddle two frames.
+ * Requests that are about to reach the player ignore the budget.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class BETAARCADE_API USpawnSchedulerComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	USpawnSchedulerComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// distanceToPlayer / speed gives the deadline
+	void QueueSpawn(FSpawnRequest request, float distanceToPlayer, float speed);
+
+	FOnSpawnRequestFinished OnSpawnFinished;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Spawning)
+		float budgetMs = 2.0f;
+
+	// Requests this close to their deadline are finished whatever the budget
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Spawning)
+		float urgentSeconds = 0.5f;
+
+	UFUNCTION(BlueprintCallable)
+		int GetQueueLength() const { return queue.Num(); }
+
+	// Frames where urgent requests pushed the work past budgetMs
+	UPROPERTY(BlueprintReadOnly, Category = Spawning)
+		int budgetOverruns = 0;
+
+private:
+
+	// Returns true when the request is done and can leave the queue
+	bool ProcessRequest(FSpawnRequest& request);
+
+	FVector GetScrolledOffset() const;
+
+	UPROPERTY()
+		TArray<FSpawnRequest> queue;
+};
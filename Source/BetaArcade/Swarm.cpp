@@ -1,11 +1,16 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "Swarm.h"
+#include "BetaArcadeMemory.h"
 #include "BetaArcadeCharacter.h"
+#include "BlueprintEventProfiler.h"
+#include "EffectPoolSubsystem.h"
 
 // Sets default values
 ASwarm::ASwarm()
 {
+	BETAARCADE_LLM_SCOPE(Swarm);
+
 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
@@ -15,7 +20,18 @@ ASwarm::ASwarm()
 // Called when the game starts or when spawned
 void ASwarm::BeginPlay()
 {
+	BETAARCADE_LLM_SCOPE(Swarm);
+
 	Super::BeginPlay();
+
+	URunnerTickManager::RegisterActor(this, ERunnerTickCategory::eSwarm);
+}
+
+void ASwarm::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	URunnerTickManager::UnregisterActor(this, ERunnerTickCategory::eSwarm);
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ASwarm::ChooseKey()
@@ -42,6 +58,11 @@ void ASwarm::ChooseKey()
 
 	player->GetSwarmKey(qteKey);
 	player->swarmReacting = false; // Resets bool once its been assigned key else it will also be success
+
+	if (UEffectPoolSubsystem* effectPool = GetWorld()->GetSubsystem<UEffectPoolSubsystem>())
+	{
+		effectPool->PlayEffect(ERunnerEffect::eSwarm, GetActorLocation(), GetActorRotation(), nullptr, this);
+	}
 }
 
 // Called every frame
@@ -58,6 +79,11 @@ bool ASwarm::CheckSuccess()
 
 void ASwarm::Failed()
 {
-	player->SetPlayerSpeed(slowSpeed);
+	BETAARCADE_BLUEPRINT_EVENT(SetPlayerSpeed, player->SetPlayerSpeed(slowSpeed));
 	player->AddPlayerLives(-1);
+
+	if (UEffectPoolSubsystem* effectPool = GetWorld()->GetSubsystem<UEffectPoolSubsystem>())
+	{
+		effectPool->PlayEffect(ERunnerEffect::eSwarmFailed, FVector::ZeroVector, FRotator::ZeroRotator, player->GetRootComponent(), this);
+	}
 }
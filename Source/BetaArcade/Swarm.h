@@ -3,11 +3,12 @@
 #pragma once
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "RunnerTickManager.h"
 #include "BetaArcadeCharacter.h"
 #include "Swarm.generated.h"
 
 UCLASS()
-class BETAARCADE_API ASwarm : public AActor
+class BETAARCADE_API ASwarm : public AActor, public IRunnerTickable
 {	
 	GENERATED_BODY()
 
@@ -33,6 +34,7 @@ public:
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	UFUNCTION(BlueprintCallable)
 		void ChooseKey();
@@ -0,0 +1,174 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AllocationCounter.h"
+#include "BetaArcade.h"
+#include "BetaArcadeBenchmark.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	// Counts game thread allocations for every frame of a run once it has settled, and fails when the
+	// average frame allocates more than the threshold. Needs a session that is already playing, for an unattended check
+	// -game -autoplay -autoplayseconds=3600 -ExecCmds="Automation RunTests BetaArcade.AllocCheck; Quit"
+	// -allocwarmup=300 -allocframes=600 -allocmaxperframe=0
+	class FAllocationCheckCommand : public IAutomationLatentCommand
+	{
+	public:
+
+		FAllocationCheckCommand(FAutomationTestBase* inTest, UWorld* inWorld, int inWarmupFrames, int inFrames, float inMaxPerFrame)
+			: test(inTest), world(inWorld), warmupFrames(inWarmupFrames), frames(inFrames), maxPerFrame(inMaxPerFrame)
+		{
+			installedCounter = !FAllocationCounter::IsInstalled();
+			FAllocationCounter::Install();
+			lastCount = FAllocationCounter::GetGameThreadAllocationCount();
+			lastFrameCounter = GFrameCounter;
+		}
+
+		virtual bool Update() override
+		{
+			// A level restart or travel replaces the world, the frames counted so far no longer mean anything
+			if (!world.IsValid())
+			{
+				test->AddError(FString::Printf(TEXT("The world went away after %d of %d frames, no result"), frame, warmupFrames + frames));
+				Stop();
+				return true;
+			}
+
+			// Latent commands update once a frame after the world, so the difference covers one whole frame
+			if (GFrameCounter == lastFrameCounter)
+			{
+				return false;
+			}
+			lastFrameCounter = GFrameCounter;
+
+			const int64 count = FAllocationCounter::GetGameThreadAllocationCount();
+			const int64 frameAllocations = count - lastCount;
+			lastCount = count;
+
+			frame++;
+			if (frame == warmupFrames)
+			{
+				FAllocationCounter::ResetRegions();
+			}
+			else if (frame > warmupFrames)
+			{
+				totalAllocations += frameAllocations;
+				worstFrame = FMath::Max(worstFrame, frameAllocations);
+				framesAllocating += frameAllocations > 0 ? 1 : 0;
+			}
+
+			if (frame < warmupFrames + frames)
+			{
+				return false;
+			}
+
+			Finish();
+			return true;
+		}
+
+	private:
+
+		void Stop()
+		{
+			if (installedCounter)
+			{
+				FAllocationCounter::Uninstall();
+			}
+		}
+
+		void Finish()
+		{
+			const double perFrame = (double)totalAllocations / frames;
+			const bool passed = perFrame <= maxPerFrame;
+
+			// Regions with the most allocations first
+			TArray<int32> regions;
+			for (int32 region = 0; region < FAllocationCounter::GetNumRegions(); ++region)
+			{
+				if (FAllocationCounter::GetRegion(region).allocations > 0)
+				{
+					regions.Add(region);
+				}
+			}
+			regions.Sort([](int32 a, int32 b) { return FAllocationCounter::GetRegion(a).allocations > FAllocationCounter::GetRegion(b).allocations; });
+
+			Stop();
+
+			UE_LOG(LogBetaArcade, Display, TEXT("AllocCheck %s: %.2f allocations per frame over %d frames (threshold %.2f), worst frame %lld, %d frames allocated"),
+				passed ? TEXT("passed") : TEXT("FAILED"), perFrame, frames, maxPerFrame, worstFrame, framesAllocating);
+
+			FString regionSummary;
+			for (int32 region : regions)
+			{
+				const FAllocationRegionStats& stats = FAllocationCounter::GetRegion(region);
+				UE_LOG(LogBetaArcade, Display, TEXT("  %-18s %8lld allocations %10lld bytes  %.2f per frame"), stats.name, stats.allocations, stats.bytes, (double)stats.allocations / frames);
+				regionSummary += FString::Printf(TEXT("%s%s:%lld"), regionSummary.IsEmpty() ? TEXT("") : TEXT(";"), stats.name, stats.allocations);
+			}
+
+			AppendBenchmarkCsv(TEXT("AllocCheck.csv"), TEXT("frames,allocationsPerFrame,worstFrame,framesAllocating,threshold,pass,regions"),
+				FString::Printf(TEXT("%d,%.3f,%lld,%d,%.3f,%d,%s\n"), frames, perFrame, worstFrame, framesAllocating, maxPerFrame, passed ? 1 : 0, *regionSummary));
+
+			if (!passed)
+			{
+				test->AddError(FString::Printf(TEXT("%.2f allocations per frame, threshold %.2f (%s)"), perFrame, maxPerFrame, *regionSummary));
+			}
+		}
+
+		FAutomationTestBase* test = nullptr;
+		TWeakObjectPtr<UWorld> world;
+		int warmupFrames = 0;
+		int frames = 0;
+		float maxPerFrame = 0.0f;
+		bool installedCounter = false;
+
+		int frame = 0;
+		uint64 lastFrameCounter = 0;
+		int64 lastCount = 0;
+		int64 totalAllocations = 0;
+		int64 worstFrame = 0;
+		int framesAllocating = 0;
+	};
+
+	UWorld* FindPlayingWorld()
+	{
+		for (const FWorldContext& context : GEngine->GetWorldContexts())
+		{
+			if ((context.WorldType == EWorldType::Game || context.WorldType == EWorldType::PIE) && context.World() && context.World()->HasBegunPlay())
+			{
+				return context.World();
+			}
+		}
+		return nullptr;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBetaArcadeAllocCheckTest, "BetaArcade.AllocCheck",
+	EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FBetaArcadeAllocCheckTest::RunTest(const FString& Parameters)
+{
+	UWorld* world = FindPlayingWorld();
+	if (!world)
+	{
+		AddError(TEXT("AllocCheck needs a game that is already playing, run it with -game on a map"));
+		return false;
+	}
+
+	int32 warmupFrames = 300;
+	int32 frames = 600;
+	float maxPerFrame = 0.0f;
+	FParse::Value(FCommandLine::Get(), TEXT("allocwarmup="), warmupFrames);
+	FParse::Value(FCommandLine::Get(), TEXT("allocframes="), frames);
+	FParse::Value(FCommandLine::Get(), TEXT("allocmaxperframe="), maxPerFrame);
+
+	ADD_LATENT_AUTOMATION_COMMAND(FAllocationCheckCommand(this, world, FMath::Max(warmupFrames, 0), FMath::Max(frames, 1), maxPerFrame));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
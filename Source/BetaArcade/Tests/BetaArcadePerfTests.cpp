@@ -0,0 +1,473 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BetaArcade.h"
+#include "BetaArcadeBenchmark.h"
+#include "BetaArcadeGameMode.h"
+#include "BetaArcadeCharacter.h"
+#include "Monster.h"
+#include "VaultBox.h"
+#include "TilePoolSubsystem.h"
+#include "TrackScrollerComponent.h"
+#include "PickUps+Hotbar/HotbarComp.h"
+#include "PickUps+Hotbar/PickUpField.h"
+#include "PickUps+Hotbar/PickUps/SpeedBoost.h"
+#include "PickUps+Hotbar/PickUps/Magnet.h"
+#include "PickUps+Hotbar/PickUps/BigScoreMultiplier.h"
+#include "PickUps+Hotbar/PickUps/LightOrb.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Performance checks for the module. Each scenario builds a standalone game world with the native game mode, runs
+ * against a per operation time budget and appends its results to Saved/Benchmarks/PerfSuite.csv. Anything over budget
+ * fails the test, and so does a scenario whose work didn't happen (tiles that didn't spawn or weren't reused,
+ * a hotbar that didn't change), so a broken path can't pass as a fast one. Headless, -nullrhi -ExecCmds="Automation RunTests BetaArcade.Perf; Quit"
+ * -perfiterations=10000 -perfbudgetscale=1 -perfmaxscaleratio=2
+ *
+ * Scale scenarios run at 1k and 10k live tiles and pickups, the usPerOp ratio between the two shows where cost stops being linear.
+ */
+
+namespace
+{
+	// Tiles kept alive while spawning and recycling, about what the level Blueprint keeps in front of the player
+	const int LIVE_TILES_WHILE_RUNNING = 8;
+	const float FRAME_SECONDS = 1.0f / 60.0f;
+
+	struct FPerfResult
+	{
+		FString scenario;
+		int count = 0;
+		double seconds = 0.0;
+		double budgetUs = 0.0;
+
+		double GetUsPerOp() const { return count > 0 ? seconds * 1000000.0 / count : 0.0; }
+		bool Passed() const { return GetUsPerOp() <= budgetUs; }
+	};
+
+	struct FPerfSettings
+	{
+		int iterations = 10000;
+		double budgetScale = 1.0;
+		float maxScaleRatio = 2.0f; // 10k may cost this much more per item than 1k before it counts as not scaling
+
+		FPerfSettings()
+		{
+			FParse::Value(FCommandLine::Get(), TEXT("perfiterations="), iterations);
+			FParse::Value(FCommandLine::Get(), TEXT("perfbudgetscale="), budgetScale);
+			FParse::Value(FCommandLine::Get(), TEXT("perfmaxscaleratio="), maxScaleRatio);
+			iterations = FMath::Max(iterations, 1);
+		}
+	};
+
+	// Standalone game world with the native game mode, no map or Blueprints needed, torn down with the scenario
+	class FPerfTestWorld
+	{
+	public:
+
+		FPerfTestWorld()
+		{
+			gameInstance = NewObject<UGameInstance>(GEngine);
+			gameInstance->AddToRoot();
+			gameInstance->InitializeStandalone();
+			world = gameInstance->GetWorld();
+
+			FURL url;
+			url.AddOption(TEXT("game=/Script/BetaArcade.BetaArcadeGameMode"));
+			world->SetGameMode(url);
+			world->InitializeActorsForPlay(url);
+			world->BeginPlay();
+
+			gameMode = world->GetAuthGameMode<ABetaArcadeGameMode>();
+			if (!gameMode)
+			{
+				return;
+			}
+
+			// The real tiles are Blueprints, a native actor stands in for all of them so only the spawn path is measured
+			gameMode->UseStandInTileClass(AVaultBox::StaticClass());
+			gameMode->UseNativeScroller();
+
+			player = world->SpawnActor<ABetaArcadeCharacter>();
+			APlayerController* controller = world->SpawnActor<APlayerController>();
+			controller->Possess(player);
+		}
+
+		~FPerfTestWorld()
+		{
+			gameInstance->Shutdown();
+			GEngine->DestroyWorldContext(world);
+			world->DestroyWorld(false);
+			gameInstance->RemoveFromRoot();
+		}
+
+		UGameInstance* gameInstance = nullptr;
+		UWorld* world = nullptr;
+		ABetaArcadeGameMode* gameMode = nullptr;
+		ABetaArcadeCharacter* player = nullptr;
+	};
+
+	// Every tile is the stand-in class, so one pool serves the whole track
+	FActorPoolStats GetStandInPoolStats(ABetaArcadeGameMode* gameMode)
+	{
+		const UTilePoolSubsystem* pool = gameMode->GetWorld()->GetSubsystem<UTilePoolSubsystem>();
+		return pool ? pool->GetStats(AVaultBox::StaticClass()) : FActorPoolStats();
+	}
+
+	FPerfResult RunTileSpawnRecycle(FAutomationTestBase& test, ABetaArcadeGameMode* gameMode, const FPerfSettings& settings)
+	{
+		FPerfResult result;
+		result.scenario = TEXT("TileSpawnRecycle");
+		result.count = settings.iterations;
+		result.budgetUs = 50.0 * settings.budgetScale;
+
+		TArray<AActor*> liveTiles;
+		liveTiles.Reserve(LIVE_TILES_WHILE_RUNNING + 1);
+		FVector location = FVector::ZeroVector;
+		int failedSpawns = 0;
+		const FActorPoolStats poolBefore = GetStandInPoolStats(gameMode);
+
+		const double startTime = FPlatformTime::Seconds();
+		for (int i = 0; i < settings.iterations; ++i)
+		{
+			AActor* tile = gameMode->SpawnRandomTile(location, FRotator::ZeroRotator);
+			location.X += gameMode->GetTileLength();
+			if (!tile)
+			{
+				failedSpawns++;
+				continue;
+			}
+			liveTiles.Add(tile);
+
+			if (liveTiles.Num() > LIVE_TILES_WHILE_RUNNING)
+			{
+				gameMode->RecycleTile(liveTiles[0]);
+				liveTiles.RemoveAt(0, 1, false);
+			}
+		}
+		result.seconds = FPlatformTime::Seconds() - startTime;
+
+		for (AActor* tile : liveTiles)
+		{
+			gameMode->RecycleTile(tile);
+		}
+
+		// A spawn path that hands out nothing, or never reuses a tile, must not pass for a fast one
+		const FActorPoolStats poolAfter = GetStandInPoolStats(gameMode);
+		test.TestEqual(TEXT("Tiles that failed to spawn"), failedSpawns, 0);
+		test.TestTrue(TEXT("Recycled tiles are reused from the pool"), poolAfter.hits - poolBefore.hits >= settings.iterations - (LIVE_TILES_WHILE_RUNNING + 1));
+		test.TestEqual(TEXT("Tiles left out of the pool"), poolAfter.liveCount, poolBefore.liveCount);
+		return result;
+	}
+
+	FPerfResult RunHotbar(FAutomationTestBase& test, ABetaArcadeCharacter* player, const FPerfSettings& settings)
+	{
+		FPerfResult result;
+		result.scenario = TEXT("Hotbar");
+		result.count = settings.iterations;
+		result.budgetUs = 10.0 * settings.budgetScale;
+
+		UHotbarComp* hotbar = player->Hotbar;
+		hotbar->Character = player;
+
+		// AddPickUp only reads the ID, the defaults are enough
+		APickUpBase* speedBoost = GetMutableDefault<ASpeedBoost>();
+		APickUpBase* scoreBonus = GetMutableDefault<ABigScoreMultiplier>();
+		APickUpBase* magnet = GetMutableDefault<AMagnet>();
+
+		// The hotbar logs every add and use, which would be most of what gets timed
+		const ELogVerbosity::Type tempVerbosity = LogTemp.GetVerbosity();
+		LogTemp.SetVerbosity(ELogVerbosity::Warning);
+
+		hotbar->PickUpIDs.Reset();
+		int wrongAfterAdd = 0;
+		int wrongAfterUse = 0;
+
+		const double startTime = FPlatformTime::Seconds();
+		for (int i = 0; i < settings.iterations; ++i)
+		{
+			hotbar->AddPickUp(speedBoost);
+			hotbar->AddPickUp(scoreBonus);
+			hotbar->AddPickUp(magnet);
+			hotbar->AddPickUp(speedBoost); // Already got one
+			wrongAfterAdd += hotbar->PickUpIDs.Num() == 3 ? 0 : 1;
+
+			hotbar->HandleHotbar(speedBoost->PickUpID);
+			hotbar->HandleHotbar(scoreBonus->PickUpID);
+			hotbar->HandleHotbar(magnet->PickUpID);
+			hotbar->RemovePickUp(magnet->PickUpID); // Not in the hotbar any more
+			wrongAfterUse += hotbar->PickUpIDs.Num() == 0 ? 0 : 1;
+		}
+		result.seconds = FPlatformTime::Seconds() - startTime;
+
+		test.TestEqual(TEXT("Rounds where the hotbar didn't hold the three pickups"), wrongAfterAdd, 0);
+		test.TestEqual(TEXT("Rounds where using the pickups didn't empty the hotbar"), wrongAfterUse, 0);
+
+		LogTemp.SetVerbosity(tempVerbosity);
+
+		player->isMagnetActive = false;
+		player->currentPowerState = PowerState::State::None;
+		return result;
+	}
+
+	FPerfResult RunHandleState(ABetaArcadeCharacter* player, const FPerfSettings& settings)
+	{
+		FPerfResult result;
+		result.scenario = TEXT("HandleState");
+		result.count = settings.iterations;
+		result.budgetUs = 5.0 * settings.budgetScale;
+
+		// Combat is left out, it flips the camera and plays sounds through Blueprint
+		const CharacterState::State states[] = { CharacterState::State::None, CharacterState::State::Jumping,
+			CharacterState::State::Sliding, CharacterState::State::Vaulting, CharacterState::State::Swarm };
+
+		const double startTime = FPlatformTime::Seconds();
+		for (int i = 0; i < settings.iterations; ++i)
+		{
+			player->SetCharacterState(states[i % UE_ARRAY_COUNT(states)]);
+			player->HandleState(FRAME_SECONDS);
+			player->StartSlide();
+		}
+		result.seconds = FPlatformTime::Seconds() - startTime;
+
+		player->SetCharacterState(CharacterState::State::None);
+		return result;
+	}
+
+	FPerfResult RunMonsterDistance(UWorld* world, const FPerfSettings& settings)
+	{
+		FPerfResult result;
+		result.scenario = TEXT("MonsterDistance");
+		result.count = settings.iterations;
+		result.budgetUs = 5.0 * settings.budgetScale;
+
+		AMonster* monster = world->SpawnActor<AMonster>();
+		monster->SetGapDrivenBySimulation(false);
+
+		const double startTime = FPlatformTime::Seconds();
+		for (int i = 0; i < settings.iterations; ++i)
+		{
+			monster->UpdateMonsterDistance(i % 4, i * 10.0f); // 0 lives is the early out
+		}
+		result.seconds = FPlatformTime::Seconds() - startTime;
+
+		monster->Destroy();
+		return result;
+	}
+
+	void RunLiveTileScale(FAutomationTestBase& test, ABetaArcadeGameMode* gameMode, int liveTiles, const FPerfSettings& settings, TArray<FPerfResult>& results)
+	{
+		const int frames = 60;
+
+		TArray<AActor*> tiles;
+		tiles.Reserve(liveTiles);
+
+		FPerfResult spawn;
+		spawn.scenario = TEXT("TileSpawnAtScale");
+		spawn.count = liveTiles;
+		spawn.budgetUs = 100.0 * settings.budgetScale; // Includes growing the pool, nothing is prewarmed this far
+
+		const FActorPoolStats poolBefore = GetStandInPoolStats(gameMode);
+
+		double startTime = FPlatformTime::Seconds();
+		for (int i = 0; i < liveTiles; ++i)
+		{
+			tiles.Add(gameMode->SpawnTileFromPool(gameMode->GetBasicTileClass(), FVector(i * gameMode->GetTileLength(), 0.0f, 0.0f), FRotator::ZeroRotator));
+		}
+		spawn.seconds = FPlatformTime::Seconds() - startTime;
+
+		tiles.Remove(nullptr);
+		test.TestEqual(TEXT("Tiles spawned at scale"), tiles.Num(), liveTiles);
+		const FVector firstTileStart = tiles.Num() > 0 ? tiles[0]->GetActorLocation() : FVector::ZeroVector;
+
+		// One op is one tile moved for one frame
+		FPerfResult scroll;
+		scroll.scenario = TEXT("TileScrollAtScale");
+		scroll.count = liveTiles * frames;
+		scroll.budgetUs = 1.0 * settings.budgetScale;
+
+		startTime = FPlatformTime::Seconds();
+		for (int frame = 0; frame < frames; ++frame)
+		{
+			gameMode->GetTrackScroller()->TickComponent(FRAME_SECONDS, LEVELTICK_All, nullptr);
+		}
+		scroll.seconds = FPlatformTime::Seconds() - startTime;
+
+		if (tiles.Num() > 0)
+		{
+			const FVector expectedOffset = gameMode->GetTrackScroller()->scrollVelocity * FRAME_SECONDS * frames;
+			test.TestTrue(TEXT("Tiles scrolled with the track"), (tiles[0]->GetActorLocation() - firstTileStart).Equals(expectedOffset, 1.0f));
+		}
+
+		FPerfResult recycle;
+		recycle.scenario = TEXT("TileRecycleAtScale");
+		recycle.count = liveTiles;
+		recycle.budgetUs = 50.0 * settings.budgetScale;
+
+		// Oldest first, the way tiles leave the track
+		startTime = FPlatformTime::Seconds();
+		for (AActor* tile : tiles)
+		{
+			gameMode->RecycleTile(tile);
+		}
+		recycle.seconds = FPlatformTime::Seconds() - startTime;
+
+		test.TestEqual(TEXT("Tiles left out of the pool after recycling"), GetStandInPoolStats(gameMode).liveCount, poolBefore.liveCount);
+
+		results.Add(spawn);
+		results.Add(scroll);
+		results.Add(recycle);
+	}
+
+	void RunPickUpScale(FAutomationTestBase& test, UWorld* world, int livePickUps, const FPerfSettings& settings, TArray<FPerfResult>& results)
+	{
+		const int frames = 60;
+
+		APickUpField* field = world->SpawnActor<APickUpField>();
+		FPickUpFieldType orbType;
+		orbType.pickUpClass = ALightOrb::StaticClass();
+		orbType.mesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Sphere.Sphere"));
+		field->orbTypes.Add(orbType);
+
+		// Lines of orbs down the track well clear of the player, so none are collected or culled while timing
+		const int orbsPerLine = 50;
+		for (int line = 0; line * orbsPerLine < livePickUps; ++line)
+		{
+			const int count = FMath::Min(orbsPerLine, livePickUps - line * orbsPerLine);
+			field->AddOrbLine(0, FVector(1000.0f, 5000.0f + line * 100.0f, 100.0f), FVector(1.0f, 0.0f, 0.0f), count, 100.0f);
+		}
+
+		test.TestEqual(TEXT("Orbs added to the field"), field->GetNumOrbs(), livePickUps);
+
+		FPerfResult tick;
+		tick.scenario = TEXT("PickUpFieldAtScale");
+		tick.count = field->GetNumOrbs() * frames;
+		tick.budgetUs = 0.5 * settings.budgetScale;
+
+		const double startTime = FPlatformTime::Seconds();
+		for (int frame = 0; frame < frames; ++frame)
+		{
+			field->Tick(FRAME_SECONDS);
+		}
+		tick.seconds = FPlatformTime::Seconds() - startTime;
+
+		test.TestEqual(TEXT("Orbs still in the field, none should be in reach of the player"), field->GetNumOrbs(), livePickUps);
+		field->Destroy();
+		results.Add(tick);
+	}
+
+	// Logs and appends every result to the CSV, and fails the test for each one over budget
+	void ReportResults(FAutomationTestBase& test, const TArray<FPerfResult>& results, const FPerfSettings& settings)
+	{
+		FString csv;
+
+		for (int i = 0; i < results.Num(); ++i)
+		{
+			const FPerfResult& result = results[i];
+
+			// Scale scenarios run at 1k then 10k under the same name, compare the cost per item with the smaller run
+			float scaleRatio = 0.0f;
+			for (int j = i - 1; j >= 0; --j)
+			{
+				if (results[j].scenario == result.scenario)
+				{
+					scaleRatio = results[j].GetUsPerOp() > 0.0 ? result.GetUsPerOp() / results[j].GetUsPerOp() : 0.0f;
+					break;
+				}
+			}
+
+			const bool passed = result.Passed() && scaleRatio <= settings.maxScaleRatio;
+
+			UE_LOG(LogBetaArcade, Display, TEXT("%-22s %6d  %9.3f ms  %8.3f us/op  budget %8.3f  %s"),
+				*result.scenario, result.count, result.seconds * 1000.0, result.GetUsPerOp(), result.budgetUs, passed ? TEXT("pass") : TEXT("FAIL"));
+
+			if (!result.Passed())
+			{
+				test.AddError(FString::Printf(TEXT("%s took %.3f us/op, budget %.3f"), *result.scenario, result.GetUsPerOp(), result.budgetUs));
+			}
+			else if (!passed)
+			{
+				test.AddError(FString::Printf(TEXT("%s costs %.2fx more per item than the smaller run, allowed %.2fx"), *result.scenario, scaleRatio, settings.maxScaleRatio));
+			}
+
+			csv += FString::Printf(TEXT("%s,%d,%.3f,%.4f,%.4f,%.3f,%d\n"), *result.scenario, result.count, result.seconds * 1000.0,
+				result.GetUsPerOp(), result.budgetUs, scaleRatio, passed ? 1 : 0);
+		}
+
+		if (!AppendBenchmarkCsv(TEXT("PerfSuite.csv"), TEXT("scenario,count,totalMs,usPerOp,budgetUs,scaleRatio,pass"), csv))
+		{
+			test.AddWarning(TEXT("Could not write PerfSuite.csv"));
+		}
+	}
+}
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FBetaArcadePerfTest, "BetaArcade.Perf",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+void FBetaArcadePerfTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	const TCHAR* scenarios[] = { TEXT("TileSpawnRecycle"), TEXT("Hotbar"), TEXT("HandleState"), TEXT("MonsterDistance"),
+		TEXT("LiveTileScale"), TEXT("PickUpScale") };
+	for (const TCHAR* scenario : scenarios)
+	{
+		OutBeautifiedNames.Add(scenario);
+		OutTestCommands.Add(scenario);
+	}
+}
+
+bool FBetaArcadePerfTest::RunTest(const FString& Parameters)
+{
+	const FPerfSettings settings;
+	FPerfTestWorld testWorld;
+	if (!testWorld.gameMode)
+	{
+		AddError(TEXT("Could not start ABetaArcadeGameMode"));
+		return false;
+	}
+
+	TArray<FPerfResult> results;
+	if (Parameters == TEXT("TileSpawnRecycle"))
+	{
+		results.Add(RunTileSpawnRecycle(*this, testWorld.gameMode, settings));
+	}
+	else if (Parameters == TEXT("Hotbar"))
+	{
+		results.Add(RunHotbar(*this, testWorld.player, settings));
+	}
+	else if (Parameters == TEXT("HandleState"))
+	{
+		results.Add(RunHandleState(testWorld.player, settings));
+	}
+	else if (Parameters == TEXT("MonsterDistance"))
+	{
+		results.Add(RunMonsterDistance(testWorld.world, settings));
+	}
+	else if (Parameters == TEXT("LiveTileScale"))
+	{
+		RunLiveTileScale(*this, testWorld.gameMode, 1000, settings, results);
+		RunLiveTileScale(*this, testWorld.gameMode, 10000, settings, results);
+	}
+	else if (Parameters == TEXT("PickUpScale"))
+	{
+		RunPickUpScale(*this, testWorld.world, 1000, settings, results);
+		RunPickUpScale(*this, testWorld.world, 10000, settings, results);
+	}
+	else
+	{
+		AddError(FString::Printf(TEXT("Unknown scenario %s"), *Parameters));
+		return false;
+	}
+
+	ReportResults(*this, results, settings);
+	return !HasAnyErrors();
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
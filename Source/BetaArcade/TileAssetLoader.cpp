@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TileAssetLoader.h"
+#include "BetaArcade.h"
+#include "Engine/AssetManager.h"
+#include "HAL/PlatformTime.h"
+
+void UTileAssetLoader::Deinitialize()
+{
+	for (TPair<FSoftObjectPath, TSharedPtr<FStreamableHandle>>& pair : handles)
+	{
+		if (pair.Value.IsValid())
+		{
+			pair.Value->ReleaseHandle();
+		}
+	}
+	handles.Empty();
+	loadStartTimes.Empty();
+
+	Super::Deinitialize();
+}
+
+TSharedPtr<FStreamableHandle> UTileAssetLoader::RequestClasses(const TArray<TSoftClassPtr<AActor>>& classes, FStreamableDelegate onLoaded)
+{
+	FStreamableManager& streamable = UAssetManager::GetStreamableManager();
+	TArray<FSoftObjectPath> classPaths;
+
+	for (const TSoftClassPtr<AActor>& softClass : classes)
+	{
+		const FSoftObjectPath classPath = softClass.ToSoftObjectPath();
+		if (classPath.IsNull())
+		{
+			continue;
+		}
+		classPaths.AddUnique(classPath);
+		if (handles.Contains(classPath))
+		{
+			continue;
+		}
+
+		loadStartTimes.Add(classPath, FPlatformTime::Seconds());
+		pendingLoads++;
+
+		TSharedPtr<FStreamableHandle> handle = streamable.RequestAsyncLoad(classPath,
+			FStreamableDelegate::CreateUObject(this, &UTileAssetLoader::OnClassLoaded, classPath));
+
+		if (handle.IsValid())
+		{
+			handles.Add(classPath, handle);
+		}
+		else
+		{
+			// Nothing to load - the delegate has already fired
+			handles.Add(classPath, nullptr);
+		}
+	}
+
+	if (classPaths.Num() == 0)
+	{
+		onLoaded.ExecuteIfBound(); // Nothing to wait for
+		return nullptr;
+	}
+
+	// The per-class handles keep everything resident, this one only waits on the whole set
+	return onLoaded.IsBound() ? streamable.RequestAsyncLoad(classPaths, onLoaded) : nullptr;
+}
+
+UClass* UTileAssetLoader::ResolveClass(const TSoftClassPtr<AActor>& softClass, bool bBlockIfNotLoaded)
+{
+	UClass* loadedClass = softClass.Get();
+	if (loadedClass || softClass.IsNull() || !bBlockIfNotLoaded)
+	{
+		return loadedClass;
+	}
+
+	const double startTime = FPlatformTime::Seconds();
+
+	TSharedPtr<FStreamableHandle>* handle = handles.Find(softClass.ToSoftObjectPath());
+	if (handle && handle->IsValid())
+	{
+		(*handle)->WaitUntilComplete();
+		loadedClass = softClass.Get();
+	}
+	else
+	{
+		loadedClass = softClass.LoadSynchronous();
+	}
+
+	UE_LOG(LogBetaArcade, Warning, TEXT("Tile class %s was not resident, blocked for %.2f ms"),
+		*softClass.ToString(), (FPlatformTime::Seconds() - startTime) * 1000.0);
+
+	return loadedClass;
+}
+
+void UTileAssetLoader::OnClassLoaded(FSoftObjectPath classPath)
+{
+	pendingLoads = FMath::Max(pendingLoads - 1, 0);
+
+	double startTime = 0.0;
+	loadStartTimes.RemoveAndCopyValue(classPath, startTime);
+
+	UE_LOG(LogBetaArcade, Log, TEXT("Loaded tile class %s in %.2f ms"),
+		*classPath.ToString(), (FPlatformTime::Seconds() - startTime) * 1000.0);
+}
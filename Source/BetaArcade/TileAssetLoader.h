@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "TileAssetLoader.generated.h"
+
+/**
+ * Streams the tile and island classes in the background and keeps them resident.
+ * Lives on the game instance so a load started in the main menu carries over into the main level.
+ */
+UCLASS()
+class BETAARCADE_API UTileAssetLoader : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	// Starts an async load for every class that isn't resident or already loading.
+	// onLoaded runs once all of them are resident, straight away if they already are.
+	TSharedPtr<FStreamableHandle> RequestClasses(const TArray<TSoftClassPtr<AActor>>& classes, FStreamableDelegate onLoaded = FStreamableDelegate());
+
+	// Returns the class if it is loaded, otherwise NULL (or blocks until it is, if allowed)
+	UClass* ResolveClass(const TSoftClassPtr<AActor>& softClass, bool bBlockIfNotLoaded);
+
+	bool IsLoading() const { return pendingLoads > 0; }
+
+private:
+
+	void OnClassLoaded(FSoftObjectPath classPath);
+
+	// Handles are kept so the classes stay in memory between maps
+	TMap<FSoftObjectPath, TSharedPtr<FStreamableHandle>> handles;
+	TMap<FSoftObjectPath, double> loadStartTimes;
+	int pendingLoads = 0;
+};
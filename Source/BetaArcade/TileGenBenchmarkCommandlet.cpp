@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TileGenBenchmarkCommandlet.h"
+#include "BetaArcade.h"
+#include "BetaArcadeGameMode.h"
+#include "VaultBox.h"
+#include "AllocationCounter.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Engine/DataTable.h"
+
+// Tiles kept alive in front of the player before the oldest is recycled
+static const int LIVE_TILES = 8;
+
+UTileGenBenchmarkCommandlet::UTileGenBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UTileGenBenchmarkCommandlet::Main(const FString& Params)
+{
+	int64 numTiles = 2000000;
+	int32 seed = 1234;
+	int32 cornerEvery = 20; // The level Blueprint places a corner every so many tiles
+	float tileLength = 1000.0f;
+	FString outputPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks/TileGen.json");
+	FString tablePath; // Optional DataTable of FTileTransitionRow, benchmarks the alias tables instead of the hard coded odds
+
+	FParse::Value(*Params, TEXT("tiles="), numTiles);
+	FParse::Value(*Params, TEXT("seed="), seed);
+	FParse::Value(*Params, TEXT("cornerevery="), cornerEvery);
+	FParse::Value(*Params, TEXT("tilelength="), tileLength);
+	FParse::Value(*Params, TEXT("output="), outputPath);
+	FParse::Value(*Params, TEXT("table="), tablePath);
+	cornerEvery = FMath::Max(cornerEvery, 1);
+
+	UDataTable* table = NULL;
+	if (!tablePath.IsEmpty())
+	{
+		table = LoadObject<UDataTable>(nullptr, *tablePath);
+		if (!table)
+		{
+			UE_LOG(LogBetaArcade, Error, TEXT("Could not load transition table %s"), *tablePath);
+			return 1;
+		}
+	}
+
+	// Standalone game world with the native game mode, it seeds its generator from FMath::Rand on BeginPlay
+	FMath::RandInit(seed);
+	UGameInstance* gameInstance = NewObject<UGameInstance>(GEngine);
+	gameInstance->InitializeStandalone();
+	UWorld* world = gameInstance->GetWorld();
+
+	FURL url;
+	url.AddOption(TEXT("game=/Script/BetaArcade.BetaArcadeGameMode"));
+	world->SetGameMode(url);
+
+	ABetaArcadeGameMode* gameMode = world->GetAuthGameMode<ABetaArcadeGameMode>();
+	if (!gameMode)
+	{
+		UE_LOG(LogBetaArcade, Error, TEXT("Could not start ABetaArcadeGameMode"));
+		gameInstance->Shutdown();
+		return 1;
+	}
+	gameMode->SetTileTransitionTable(table);
+	gameMode->UseStandInTileClass(AVaultBox::StaticClass());
+
+	world->InitializeActorsForPlay(url);
+	world->BeginPlay();
+
+	// Each tile leaves the next transform on its end arrow, corners turn it a quarter either way
+	FRandomStream turnStream(seed);
+	TArray<AActor*> liveTiles;
+	liveTiles.Reserve(LIVE_TILES + 1);
+	int64 tilesSpawned = 0;
+
+	FAllocationCounter::Install();
+	const double startTime = FPlatformTime::Seconds();
+
+	for (int64 i = 1; i <= numTiles; ++i)
+	{
+		const bool corner = i % cornerEvery == 0;
+		AActor* tile = corner ? gameMode->SpawnCornerTile(gameMode->nextTileLocation, gameMode->nextTileRotation)
+			: gameMode->SpawnRandomTile(gameMode->nextTileLocation, gameMode->nextTileRotation);
+		if (!tile)
+		{
+			break;
+		}
+		tilesSpawned++;
+
+		FRotator nextRotation = gameMode->nextTileRotation;
+		nextRotation.Yaw = FRotator::NormalizeAxis(nextRotation.Yaw + (corner ? (turnStream.RandRange(0, 1) ? -90.0f : 90.0f) : 0.0f));
+		gameMode->SetNewTransforms(gameMode->nextTileLocation + gameMode->nextTileRotation.Vector() * tileLength, nextRotation);
+
+		// Passed tiles go back to the pool, the way the level Blueprint recycles them
+		liveTiles.Add(tile);
+		if (liveTiles.Num() > LIVE_TILES)
+		{
+			gameMode->RecycleTile(liveTiles[0]);
+			liveTiles.RemoveAt(0, 1, false);
+		}
+	}
+
+	const double elapsed = FPlatformTime::Seconds() - startTime;
+	const int64 allocations = FAllocationCounter::GetAllocationCount();
+	FAllocationCounter::Uninstall();
+
+	const FTrackGeneratorStats stats = gameMode->GetTrackStats();
+	const int planUnderflows = gameMode->GetTilePlanUnderflows();
+	// The planner rolls the tiles (and a few planned past the end), the game mode's own generator only rolls on an underflow
+	const int64 noRepeatFired = gameMode->GetTilePlanStats().noRepeatFired + stats.noRepeatFired;
+	const FVector finalLocation = gameMode->nextTileLocation;
+
+	gameInstance->Shutdown();
+	world->DestroyWorld(false);
+
+	if (tilesSpawned < numTiles)
+	{
+		UE_LOG(LogBetaArcade, Error, TEXT("Tile %lld did not spawn"), tilesSpawned + 1);
+		return 1;
+	}
+
+	const double tilesPerSecond = elapsed > 0.0 ? tilesSpawned / elapsed : 0.0;
+
+	FString histogram;
+	const UEnum* tileEnum = StaticEnum<ETileType>();
+	for (int t = 0; t < NUM_TILE_TYPES; ++t)
+	{
+		histogram += FString::Printf(TEXT("%s\"%s\": %lld"), t > 0 ? TEXT(", ") : TEXT(""),
+			*tileEnum->GetNameStringByValue(t), stats.tileCounts[t]);
+	}
+
+	const FString json = FString::Printf(
+		TEXT("{\"seed\": %d, \"transitionTable\": %s, \"tiles\": %lld, \"seconds\": %.6f, \"tilesPerSecond\": %.1f, \"allocationsPerTile\": %.6f, ")
+		TEXT("\"noRepeatFired\": %lld, \"planUnderflows\": %d, \"finalLocation\": [%.1f, %.1f, %.1f], \"histogram\": {%s}}"),
+		seed, table ? TEXT("true") : TEXT("false"), tilesSpawned, elapsed, tilesPerSecond, tilesSpawned > 0 ? (double)allocations / tilesSpawned : 0.0,
+		noRepeatFired, planUnderflows, finalLocation.X, finalLocation.Y, finalLocation.Z, *histogram);
+
+	UE_LOG(LogBetaArcade, Display, TEXT("%s"), *json);
+
+	if (!FFileHelper::SaveStringToFile(json + LINE_TERMINATOR, *outputPath))
+	{
+		UE_LOG(LogBetaArcade, Error, TEXT("Could not write %s"), *outputPath);
+		return 1;
+	}
+
+	return 0;
+}
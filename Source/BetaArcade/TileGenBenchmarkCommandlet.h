@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TileGenBenchmarkCommandlet.generated.h"
+
+/**
+ * Drives the game mode's tile path headless, SpawnRandomTile or SpawnCornerTile then SetNewTransforms for every tile,
+ * with a native stand in for the tile Blueprints, and writes the results as JSON.
+ * UE4Editor-Cmd BetaArcade.uproject -run=TileGenBenchmark -nullrhi -tiles=2000000 -seed=1234 -output=TileGen.json
+ */
+UCLASS()
+class UTileGenBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UTileGenBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,253 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TilePoolSubsystem.h"
+#include "BetaArcade.h"
+#include "PooledActor.h"
+#include "RunnerTickManager.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+const FVector UTilePoolSubsystem::PARK_LOCATION = { 0.0f, 0.0f, -100000.0f };
+
+void UTilePoolSubsystem::Deinitialize()
+{
+	LogStats();
+	pools.Empty();
+
+	Super::Deinitialize();
+}
+
+void UTilePoolSubsystem::Prewarm(TSubclassOf<AActor> actorClass, int32 count, AActor* owner)
+{
+	UWorld* world = GetWorld();
+	if (!world || !actorClass)
+	{
+		return;
+	}
+
+	FActorSpawnParameters spawnParams;
+	spawnParams.Owner = owner;
+	spawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	FActorPool& pool = pools.FindOrAdd(actorClass);
+	while (pool.freeActors.Num() < count)
+	{
+		AActor* actor = world->SpawnActor<AActor>(actorClass, PARK_LOCATION, FRotator::ZeroRotator, spawnParams);
+		if (!actor)
+		{
+			break;
+		}
+		SetPooledActorActive(actor, false);
+		pool.freeActors.Add(actor);
+	}
+	pool.stats.freeCount = pool.freeActors.Num();
+}
+
+AActor* UTilePoolSubsystem::Acquire(TSubclassOf<AActor> actorClass, const FVector& location, const FRotator& rotation, AActor* owner)
+{
+	UWorld* world = GetWorld();
+	if (!world || !actorClass)
+	{
+		return NULL;
+	}
+
+	FActorPool& pool = pools.FindOrAdd(actorClass);
+	AActor* actor = TakeFree(pool, FTransform(rotation, location), owner);
+
+	if (actor)
+	{
+		pool.stats.hits++;
+	}
+	else
+	{
+		pool.stats.misses++;
+
+		FActorSpawnParameters spawnParams;
+		spawnParams.Owner = owner;
+		actor = world->SpawnActor<AActor>(actorClass, location, rotation, spawnParams);
+		if (!actor)
+		{
+			return NULL;
+		}
+	}
+
+	CountAcquire(pool);
+	return actor;
+}
+
+AActor* UTilePoolSubsystem::AcquireDeferred(TSubclassOf<AActor> actorClass, const FTransform& transform, AActor* owner, bool& needsFinishSpawning)
+{
+	needsFinishSpawning = false;
+
+	UWorld* world = GetWorld();
+	if (!world || !actorClass)
+	{
+		return NULL;
+	}
+
+	FActorPool& pool = pools.FindOrAdd(actorClass);
+	AActor* actor = TakeFree(pool, transform, owner);
+
+	if (actor)
+	{
+		pool.stats.hits++;
+	}
+	else
+	{
+		pool.stats.misses++;
+
+		actor = world->SpawnActorDeferred<AActor>(actorClass, transform, owner, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (!actor)
+		{
+			return NULL;
+		}
+		needsFinishSpawning = true;
+	}
+
+	CountAcquire(pool);
+	return actor;
+}
+
+AActor* UTilePoolSubsystem::TakeFree(FActorPool& pool, const FTransform& transform, AActor* owner)
+{
+	AActor* actor = NULL;
+
+	// Skip anything that was destroyed behind our back (level cleanup, Blueprint DestroyActor)
+	while (pool.freeActors.Num() > 0 && !actor)
+	{
+		actor = pool.freeActors.Pop(false);
+		if (actor && actor->IsPendingKillPending())
+		{
+			actor = NULL;
+		}
+	}
+
+	if (actor)
+	{
+		actor->SetOwner(owner);
+		actor->SetActorLocationAndRotation(transform.GetLocation(), transform.Rotator(), false, nullptr, ETeleportType::TeleportPhysics);
+		SetPooledActorActive(actor, true);
+
+		if (actor->GetClass()->ImplementsInterface(UPooledActor::StaticClass()))
+		{
+			IPooledActor::Execute_OnAcquiredFromPool(actor);
+		}
+	}
+
+	return actor;
+}
+
+void UTilePoolSubsystem::CountAcquire(FActorPool& pool)
+{
+	pool.stats.liveCount++;
+	pool.stats.highWater = FMath::Max(pool.stats.highWater, pool.stats.liveCount);
+	pool.stats.freeCount = pool.freeActors.Num();
+}
+
+bool UTilePoolSubsystem::Release(AActor* actor)
+{
+	if (!actor || actor->IsPendingKillPending())
+	{
+		return false;
+	}
+
+	FActorPool& pool = pools.FindOrAdd(actor->GetClass());
+	if (pool.freeActors.Contains(actor))
+	{
+		return false; // Already released
+	}
+
+	if (actor->GetClass()->ImplementsInterface(UPooledActor::StaticClass()))
+	{
+		IPooledActor::Execute_OnReturnedToPool(actor);
+	}
+
+	SetPooledActorActive(actor, false);
+	actor->SetActorLocation(PARK_LOCATION, false, nullptr, ETeleportType::TeleportPhysics);
+	pool.freeActors.Add(actor);
+
+	pool.stats.liveCount = FMath::Max(pool.stats.liveCount - 1, 0);
+	pool.stats.freeCount = pool.freeActors.Num();
+
+	return true;
+}
+
+FActorPoolStats UTilePoolSubsystem::GetStats(TSubclassOf<AActor> actorClass) const
+{
+	const FActorPool* pool = pools.Find(actorClass);
+	return pool ? pool->stats : FActorPoolStats();
+}
+
+int32 UTilePoolSubsystem::GetNumLiveActors() const
+{
+	int32 liveActors = 0;
+	for (const TPair<UClass*, FActorPool>& pair : pools)
+	{
+		liveActors += pair.Value.stats.liveCount;
+	}
+	return liveActors;
+}
+
+void UTilePoolSubsystem::GetCensus(TArray<FActorPoolCensus>& outCensus) const
+{
+	for (const TPair<UClass*, FActorPool>& pair : pools)
+	{
+		FActorPoolCensus& census = outCensus.AddDefaulted_GetRef();
+		census.actorClass = pair.Key;
+		census.stats = pair.Value.stats;
+
+		// Handed out actors aren't tracked, so a parked one stands in for all of them
+		const AActor* sample = pair.Value.freeActors.Num() > 0 ? pair.Value.freeActors[0] : nullptr;
+		const int64 actorBytes = sample ? GetActorBytes(sample) : (pair.Key ? pair.Key->GetStructureSize() : 0);
+		census.bytes = actorBytes * (census.stats.liveCount + census.stats.freeCount);
+	}
+}
+
+int64 UTilePoolSubsystem::GetActorBytes(const AActor* actor)
+{
+	if (!actor)
+	{
+		return 0;
+	}
+
+	int64 bytes = actor->GetClass()->GetStructureSize();
+
+	TInlineComponentArray<UActorComponent*> components(actor);
+	for (UActorComponent* component : components)
+	{
+		bytes += component->GetClass()->GetStructureSize() + component->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+	}
+	return bytes;
+}
+
+void UTilePoolSubsystem::LogStats() const
+{
+	for (const TPair<UClass*, FActorPool>& pair : pools)
+	{
+		const FActorPoolStats& stats = pair.Value.stats;
+		UE_LOG(LogBetaArcade, Log, TEXT("Tile pool %s: hits %d, misses %d, high water %d, live %d, free %d"),
+			*GetNameSafe(pair.Key), stats.hits, stats.misses, stats.highWater, stats.liveCount, stats.freeCount);
+	}
+}
+
+void UTilePoolSubsystem::SetPooledActorActive(AActor* actor, bool active)
+{
+	actor->SetActorHiddenInGame(!active);
+	actor->SetActorEnableCollision(active);
+	if (actor->PrimaryActorTick.bCanEverTick)
+	{
+		// Actors whose tick URunnerTickManager owns stay off unless their Blueprint has an Event Tick
+		actor->SetActorTickEnabled(active && URunnerTickManager::NeedsActorTick(actor));
+	}
+
+	// Pickups and obstacles spawned by the tile Blueprint are attached to it
+	TArray<AActor*> attachedActors;
+	actor->GetAttachedActors(attachedActors);
+	for (AActor* attached : attachedActors)
+	{
+		if (attached)
+		{
+			SetPooledActorActive(attached, active);
+		}
+	}
+}
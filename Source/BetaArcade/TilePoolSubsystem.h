@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TilePoolSubsystem.generated.h"
+
+USTRUCT(BlueprintType)
+struct FActorPoolStats
+{
+	GENERATED_BODY()
+
+	// Acquires served from the free list
+	UPROPERTY(BlueprintReadOnly, Category = Pool)
+		int32 hits = 0;
+	// Acquires that had to spawn a new actor
+	UPROPERTY(BlueprintReadOnly, Category = Pool)
+		int32 misses = 0;
+	// Most actors of this class handed out at the same time
+	UPROPERTY(BlueprintReadOnly, Category = Pool)
+		int32 highWater = 0;
+	UPROPERTY(BlueprintReadOnly, Category = Pool)
+		int32 liveCount = 0;
+	UPROPERTY(BlueprintReadOnly, Category = Pool)
+		int32 freeCount = 0;
+};
+
+// One class's row in BetaArcade.Census
+struct FActorPoolCensus
+{
+	UClass* actorClass = nullptr;
+	FActorPoolStats stats;
+	int64 bytes = 0; // Live and parked actors, estimated from one parked instance
+};
+
+USTRUCT()
+struct FActorPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		TArray<AActor*> freeActors;
+
+	FActorPoolStats stats;
+};
+
+/**
+ * Keeps hidden, parked instances of tile classes around so the track can reuse them instead of
+ * calling SpawnActor / Destroy for every tile. Pools are keyed by class.
+ */
+UCLASS()
+class BETAARCADE_API UTilePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	// Spawns parked instances until the pool for actorClass holds at least count free actors
+	void Prewarm(TSubclassOf<AActor> actorClass, int32 count, AActor* owner);
+
+	// Takes an actor from the pool, or spawns one if the pool is empty
+	AActor* Acquire(TSubclassOf<AActor> actorClass, const FVector& location, const FRotator& rotation, AActor* owner);
+
+	// Like Acquire, but a pool miss is spawned deferred and needsFinishSpawning is set.
+	// The caller must call FinishSpawning on it, possibly on a later frame.
+	AActor* AcquireDeferred(TSubclassOf<AActor> actorClass, const FTransform& transform, AActor* owner, bool& needsFinishSpawning);
+
+	// Hides the actor and puts it back on the free list for its class
+	bool Release(AActor* actor);
+
+	FActorPoolStats GetStats(TSubclassOf<AActor> actorClass) const;
+
+	// Pooled actors currently handed out, across every class
+	int32 GetNumLiveActors() const;
+
+	void GetCensus(TArray<FActorPoolCensus>& outCensus) const;
+
+	// Class, component and component resource sizes of one actor
+	static int64 GetActorBytes(const AActor* actor);
+
+	void LogStats() const;
+
+	// Where released actors are parked, well below the track
+	static const FVector PARK_LOCATION;
+
+private:
+
+	static void SetPooledActorActive(AActor* actor, bool active);
+
+	AActor* TakeFree(FActorPool& pool, const FTransform& transform, AActor* owner);
+	void CountAcquire(FActorPool& pool);
+
+	UPROPERTY()
+		TMap<UClass*, FActorPool> pools;
+};
@@ -0,0 +1,171 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrackGenerator.h"
+
+ETileType FTrackGenerator::NextTileType(ETileType previousTile)
+{
+	if (previousTile != ETileType::eBasic && previousTile != ETileType::eCorner)
+	{
+		return ETileType::eBasic; // Never two obstacles next to each other
+	}
+
+	if (hasTransitionTable && !transitionTables[(int)lastObstacleTile].IsEmpty())
+	{
+		return transitionTables[(int)lastObstacleTile].Sample(stream);
+	}
+
+	return LegacyTileType();
+}
+
+ETileType FTrackGenerator::LegacyTileType()
+{
+	int obstacleSpawn = stream.RandRange(0, 99);
+	if (obstacleSpawn > 50) // Lower Number to turn down Obstacle Spawning
+	{
+		return ETileType::eBasic;
+	}
+
+	//Spawn an Obstacle Tile
+	int randomModule = stream.RandRange(1, 9); // Obstacle Spawning is done with random number Generator
+	int duplicateTest = randomModule > 5 ? randomModule - 5 : randomModule;
+
+	if (lastObstacleTile == ETileType(duplicateTest)) //To never get the same obstacle twice in a row
+	{
+		stats.noRepeatFired++;
+		randomModule++;
+		if (randomModule > 9)
+		{
+			randomModule = 1;
+		}
+	}
+
+	if (randomModule == 1 || randomModule == 6) // Vault
+	{
+		return ETileType::eVault;
+	}
+	else if (randomModule == 2 || randomModule == 7) // Slide
+	{
+		return ETileType::eSlide;
+	}
+	else if (randomModule == 3 || randomModule == 8) // Jump
+	{
+		return ETileType::eJump;
+	}
+	else if (randomModule == 4 || randomModule == 9) // Cliff
+	{
+		return ETileType::eCliff;
+	}
+	else if (randomModule == 5) // Swarm
+	{
+		return ETileType::eSwarm;
+	}
+
+	//ERROR
+	return ETileType::eBasic;
+}
+
+void FTrackGenerator::BuildTransitionTable(const TArray<FTileTransitionRow*>& rows)
+{
+	TArray<ETileType> tileTypes[NUM_TILE_TYPES];
+	TArray<float> weights[NUM_TILE_TYPES];
+
+	for (const FTileTransitionRow* row : rows)
+	{
+		// Corners are placed by the level, not rolled
+		if (row && row->weight > 0.0f && row->nextTile != ETileType::eCorner && row->previousObstacle != ETileType::eCorner)
+		{
+			tileTypes[(int)row->previousObstacle].Add(row->nextTile);
+			weights[(int)row->previousObstacle].Add(row->weight);
+		}
+	}
+
+	hasTransitionTable = false;
+	for (int state = 0; state < NUM_TILE_TYPES; ++state)
+	{
+		transitionTables[state].Build(tileTypes[state], weights[state]);
+		hasTransitionTable |= !transitionTables[state].IsEmpty();
+	}
+}
+
+void FTrackGenerator::RecordSpawnedTile(ETileType tileType)
+{
+	stats.tilesGenerated++;
+	stats.tileCounts[(int)tileType]++;
+
+	if (tileType != ETileType::eBasic && tileType != ETileType::eCorner)
+	{
+		lastObstacleTile = tileType;
+	}
+}
+
+void FTileAliasTable::Build(const TArray<ETileType>& tileTypes, const TArray<float>& weights)
+{
+	const int count = tileTypes.Num();
+	outcomes = tileTypes;
+	probability.Init(1.0f, count);
+	alias.Init(0, count);
+
+	float totalWeight = 0.0f;
+	for (float weight : weights)
+	{
+		totalWeight += weight;
+	}
+	if (count == 0 || totalWeight <= 0.0f)
+	{
+		outcomes.Empty();
+		return;
+	}
+
+	// Scale so the average bucket is exactly 1, then pair each under-full bucket with an over-full one
+	TArray<float> scaled;
+	TArray<int> small;
+	TArray<int> large;
+	scaled.SetNumUninitialized(count);
+	for (int i = 0; i < count; ++i)
+	{
+		scaled[i] = weights[i] * count / totalWeight;
+		if (scaled[i] < 1.0f)
+		{
+			small.Add(i);
+		}
+		else
+		{
+			large.Add(i);
+		}
+	}
+
+	while (small.Num() > 0 && large.Num() > 0)
+	{
+		const int less = small.Pop(false);
+		const int more = large.Pop(false);
+
+		probability[less] = scaled[less];
+		alias[less] = (uint8)more;
+
+		scaled[more] = (scaled[more] + scaled[less]) - 1.0f;
+		if (scaled[more] < 1.0f)
+		{
+			small.Add(more);
+		}
+		else
+		{
+			large.Add(more);
+		}
+	}
+
+	// Anything left over is full (or off by rounding)
+	for (int i : small)
+	{
+		probability[i] = 1.0f;
+	}
+	for (int i : large)
+	{
+		probability[i] = 1.0f;
+	}
+}
+
+ETileType FTileAliasTable::Sample(const FRandomStream& stream) const
+{
+	const int bucket = stream.RandHelper(outcomes.Num());
+	return stream.GetFraction() < probability[bucket] ? outcomes[bucket] : outcomes[alias[bucket]];
+}
@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+#include "Engine/DataTable.h"
+#include "TrackGenerator.generated.h"
+
+UENUM(BlueprintType)
+enum class ETileType : uint8 // Enum Class for Tile Type
+{
+	eBasic,
+	eVault,
+	eSlide,
+	eJump,
+	eCliff,
+	eSwarm,
+	eCorner,
+};
+
+static const int NUM_TILE_TYPES = (int)ETileType::eCorner + 1;
+
+// One edge of the tile transition matrix, edited by designers in a DataTable
+USTRUCT(BlueprintType)
+struct FTileTransitionRow : public FTableRowBase
+{
+	GENERATED_BODY()
+
+	// Last obstacle placed (eBasic at the start of a run)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Tile)
+		ETileType previousObstacle = ETileType::eBasic;
+
+	// Tile placed after a basic or corner tile, eBasic is "no obstacle"
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Tile)
+		ETileType nextTile = ETileType::eBasic;
+
+	// Relative odds against the other rows with the same previousObstacle
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Tile)
+		float weight = 1.0f;
+};
+
+// Walker/Vose alias table, draws one of N weighted outcomes with a single roll whatever N is
+struct BETAARCADE_API FTileAliasTable
+{
+	void Build(const TArray<ETileType>& tileTypes, const TArray<float>& weights);
+	ETileType Sample(const FRandomStream& stream) const;
+	bool IsEmpty() const { return outcomes.Num() == 0; }
+
+	TArray<ETileType> outcomes;
+	TArray<float> probability;
+	TArray<uint8> alias;
+};
+
+struct FTrackGeneratorStats
+{
+	int64 tilesGenerated = 0;
+	int64 noRepeatFired = 0; // Times the "never the same obstacle twice" rule changed the roll
+	int64 tileCounts[NUM_TILE_TYPES] = {};
+};
+
+/**
+ * Picks the next tile of the track. Kept free of UObjects and the world so it can be driven
+ * headless by the benchmark commandlet as well as by the Game Mode.
+ */
+struct BETAARCADE_API FTrackGenerator
+{
+	void Seed(int32 seed) { stream.Initialize(seed); }
+
+	// Gets Random Obstacle, previousTile is the last tile placed (corners count as basic)
+	ETileType NextTileType(ETileType previousTile);
+
+	// Compiles the rows into one alias table per previous obstacle, empty rows go back to the hard coded odds
+	void BuildTransitionTable(const TArray<FTileTransitionRow*>& rows);
+	bool HasTransitionTable() const { return hasTransitionTable; }
+
+	// Remembers the last obstacle for the no repeat rule and updates the stats
+	void RecordSpawnedTile(ETileType tileType);
+
+	// Used to Randomly select a Left or Right module
+	bool ChooseLeftVariant() { return stream.RandRange(0, 9) <= 4; }
+
+	ETileType lastObstacleTile = ETileType::eBasic;
+	FTrackGeneratorStats stats;
+	FRandomStream stream;
+
+private:
+
+	ETileType LegacyTileType();
+
+	FTileAliasTable transitionTables[NUM_TILE_TYPES];
+	bool hasTransitionTable = false;
+};
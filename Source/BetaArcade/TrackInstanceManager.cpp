@@ -0,0 +1,161 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrackInstanceManager.h"
+#include "BetaArcade.h"
+#include "BetaArcadeTrace.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Rebase Track Instances"), STAT_RebaseTrackInstances, STATGROUP_BetaArcade);
+
+// A zero scale instance is culled, used for free slots
+static const FTransform HIDDEN_INSTANCE = FTransform(FRotator::ZeroRotator, FVector(0.0f, 0.0f, -100000.0f), FVector::ZeroVector);
+
+ATrackInstanceManager::ATrackInstanceManager()
+{
+	PrimaryActorTick.bCanEverTick = true; // Only checks how far it has scrolled
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	RootComponent->SetMobility(EComponentMobility::Movable);
+}
+
+void ATrackInstanceManager::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	const FVector offset = GetActorLocation();
+	if (offset.SizeSquared() >= FMath::Square(rebaseDistance))
+	{
+		Rebase(offset);
+	}
+}
+
+void ATrackInstanceManager::Rebase(const FVector& offset)
+{
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_RebaseTrackInstances);
+
+	// World positions don't change, so it doesn't matter where in the frame this lands relative to the scroller
+	SetActorLocation(FVector::ZeroVector, false, nullptr, ETeleportType::TeleportPhysics);
+
+	// Free slots stay where they were hidden
+	for (const TPair<AActor*, FTrackInstanceList>& pair : registeredActors)
+	{
+		for (const FTrackInstance& instance : pair.Value.instances)
+		{
+			FTransform transform;
+			if (instance.instances && instance.instances->GetInstanceTransform(instance.index, transform, false))
+			{
+				transform.AddToTranslation(offset);
+				instance.instances->UpdateInstanceTransform(instance.index, transform, false, true, true);
+			}
+		}
+	}
+}
+
+void ATrackInstanceManager::RegisterActor(AActor* actor)
+{
+	if (!actor || registeredActors.Contains(actor) || instancedMeshes.Num() == 0)
+	{
+		return;
+	}
+
+	FTrackInstanceList& list = registeredActors.Add(actor);
+
+	TInlineComponentArray<UStaticMeshComponent*> meshComponents(actor);
+	for (UStaticMeshComponent* meshComponent : meshComponents)
+	{
+		UStaticMesh* mesh = meshComponent->GetStaticMesh();
+		if (!mesh || !meshComponent->IsVisible() || meshComponent->IsA<UInstancedStaticMeshComponent>() || !instancedMeshes.Contains(mesh))
+		{
+			continue;
+		}
+
+		FTrackInstance instance;
+		instance.instances = GetOrCreateInstances(mesh);
+		instance.source = meshComponent;
+
+		TArray<int32>& slots = freeSlots.FindOrAdd(instance.instances);
+		if (slots.Num() > 0)
+		{
+			instance.index = slots.Pop(false);
+			instance.instances->UpdateInstanceTransform(instance.index, meshComponent->GetComponentTransform(), true, true, true);
+		}
+		else
+		{
+			instance.index = instance.instances->AddInstanceWorldSpace(meshComponent->GetComponentTransform());
+		}
+
+		// Collision stays on the original component, only the drawing moves
+		meshComponent->SetVisibility(false);
+		list.instances.Add(instance);
+		numActiveInstances++;
+	}
+}
+
+void ATrackInstanceManager::UnregisterActor(AActor* actor)
+{
+	FTrackInstanceList list;
+	if (!registeredActors.RemoveAndCopyValue(actor, list))
+	{
+		return;
+	}
+
+	for (const FTrackInstance& instance : list.instances)
+	{
+		if (instance.instances)
+		{
+			instance.instances->UpdateInstanceTransform(instance.index, HIDDEN_INSTANCE, false, true, true);
+			freeSlots.FindOrAdd(instance.instances).Add(instance.index);
+		}
+		if (instance.source)
+		{
+			instance.source->SetVisibility(true);
+		}
+		numActiveInstances--;
+	}
+}
+
+int ATrackInstanceManager::GetNumInstanceSlots() const
+{
+	int slots = 0;
+	for (const TPair<UStaticMesh*, UHierarchicalInstancedStaticMeshComponent*>& pair : meshInstances)
+	{
+		slots += pair.Value ? pair.Value->GetInstanceCount() : 0;
+	}
+	return slots;
+}
+
+UHierarchicalInstancedStaticMeshComponent* ATrackInstanceManager::GetOrCreateInstances(UStaticMesh* mesh)
+{
+	if (UHierarchicalInstancedStaticMeshComponent** existing = meshInstances.Find(mesh))
+	{
+		return *existing;
+	}
+
+	UHierarchicalInstancedStaticMeshComponent* instances = NewObject<UHierarchicalInstancedStaticMeshComponent>(this);
+	instances->SetStaticMesh(mesh);
+	instances->SetMobility(EComponentMobility::Movable);
+	instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	instances->SetGenerateOverlapEvents(false);
+	instances->SetupAttachment(RootComponent);
+	instances->RegisterComponent();
+
+	meshInstances.Add(mesh, instances);
+	return instances;
+}
+
+static FAutoConsoleCommandWithWorld InstanceCountsCommand(
+	TEXT("BetaArcade.InstanceCounts"),
+	TEXT("Logs active instances, instance slots and HISM components of the track instance manager"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* world)
+	{
+		for (TActorIterator<ATrackInstanceManager> it(world); it; ++it)
+		{
+			UE_LOG(LogBetaArcade, Display, TEXT("TrackInstances active=%d slots=%d components=%d"),
+				it->GetNumInstances(), it->GetNumInstanceSlots(), it->GetNumComponents());
+		}
+	}));
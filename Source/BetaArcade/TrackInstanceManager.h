@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "TrackInstanceManager.generated.h"
+
+class UStaticMesh;
+class UStaticMeshComponent;
+class UHierarchicalInstancedStaticMeshComponent;
+
+USTRUCT()
+struct FTrackInstance
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		UHierarchicalInstancedStaticMeshComponent* instances = nullptr;
+	UPROPERTY()
+		UStaticMeshComponent* source = nullptr;
+
+	int32 index = INDEX_NONE;
+};
+
+USTRUCT()
+struct FTrackInstanceList
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		TArray<FTrackInstance> instances;
+};
+
+/**
+ * Draws the repeated meshes of tiles and islands through one HISM component per mesh.
+ * The original mesh components are hidden but keep their collision. Instances live in this
+ * actor's space, so the track scroller moves them all by moving this actor. Once it has moved
+ * rebaseDistance the actor goes back to the origin and the live instances take the offset instead.
+ */
+UCLASS()
+class BETAARCADE_API ATrackInstanceManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	ATrackInstanceManager();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	// Meshes drawn through instancing, anything else on a tile renders as normal
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Instancing)
+		TArray<UStaticMesh*> instancedMeshes;
+
+	// How far the scroller can carry the actor before the offset is folded back into the instances,
+	// past this new tiles would sit this far out in instance space and lose float precision
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Instancing)
+		float rebaseDistance = 100000.0f;
+
+	// Moves the actor's matching meshes into instances
+	UFUNCTION(BlueprintCallable)
+		void RegisterActor(AActor* actor);
+
+	// Gives the actor its meshes back and frees the instance slots for the next tile
+	UFUNCTION(BlueprintCallable)
+		void UnregisterActor(AActor* actor);
+
+	UFUNCTION(BlueprintCallable)
+		int GetNumInstances() const { return numActiveInstances; }
+	UFUNCTION(BlueprintCallable)
+		int GetNumInstanceSlots() const;
+	UFUNCTION(BlueprintCallable)
+		int GetNumComponents() const { return meshInstances.Num(); }
+
+private:
+
+	UHierarchicalInstancedStaticMeshComponent* GetOrCreateInstances(UStaticMesh* mesh);
+	void Rebase(const FVector& offset);
+
+	UPROPERTY()
+		TMap<UStaticMesh*, UHierarchicalInstancedStaticMeshComponent*> meshInstances;
+
+	UPROPERTY()
+		TMap<AActor*, FTrackInstanceList> registeredActors;
+
+	// Hidden instances ready for reuse, removing from a HISM reorders it so slots are never removed
+	TMap<UHierarchicalInstancedStaticMeshComponent*, TArray<int32>> freeSlots;
+
+	int numActiveInstances = 0;
+};
@@ -0,0 +1,149 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrackPlanner.h"
+#include "Async/Async.h"
+
+FTrackPlanner::~FTrackPlanner()
+{
+	Stop();
+}
+
+void FTrackPlanner::Start(const FTrackGenerator& inGenerator, float inTileLength)
+{
+	Stop();
+
+	generator = inGenerator;
+	tileLength = inTileLength;
+	previousTile = ETileType::eBasic;
+	plannedDistance = 0.0f;
+	head = 0;
+	tail = 0;
+	underflows = 0;
+	running = true;
+
+	RequestRefill();
+}
+
+void FTrackPlanner::Stop()
+{
+	if (refillTask.IsValid())
+	{
+		refillTask.Wait();
+		refillTask = TFuture<void>();
+	}
+	running = false;
+}
+
+FTrackGeneratorStats FTrackPlanner::GetGeneratorStats() const
+{
+	if (refillTask.IsValid())
+	{
+		refillTask.Wait();
+	}
+	return generator.stats;
+}
+
+void FTrackPlanner::SetHorizon(int tiles)
+{
+	horizon = FMath::Clamp(tiles, 1, CAPACITY - 1);
+	RequestRefill();
+}
+
+bool FTrackPlanner::Pop(FPlannedTile& outTile)
+{
+	if (!running)
+	{
+		return false;
+	}
+
+	if (Num() == 0)
+	{
+		// Plan ran dry (horizon too short for the speed), wait for the worker rather than guess
+		underflows++;
+		RequestRefill();
+		if (refillTask.IsValid())
+		{
+			refillTask.Wait();
+		}
+		if (Num() == 0)
+		{
+			return false;
+		}
+	}
+
+	const uint32 index = head.Load();
+	outTile = entries[index % CAPACITY];
+	head = index + 1;
+
+	RequestRefill();
+	return true;
+}
+
+int FTrackPlanner::Peek(TArray<FPlannedTile>& outTiles, int maxTiles) const
+{
+	const uint32 first = head.Load();
+	const int count = FMath::Min(maxTiles, (int)(tail.Load() - first));
+
+	outTiles.Reset(count);
+	for (int i = 0; i < count; ++i)
+	{
+		outTiles.Add(entries[(first + i) % CAPACITY]);
+	}
+	return count;
+}
+
+bool FTrackPlanner::PeekNext(FPlannedTile& outTile) const
+{
+	const uint32 first = head.Load();
+	if (tail.Load() == first)
+	{
+		return false;
+	}
+
+	outTile = entries[first % CAPACITY];
+	return true;
+}
+
+void FTrackPlanner::RequestRefill()
+{
+	if (!running || Num() >= horizon.Load())
+	{
+		return;
+	}
+
+	bool expected = false;
+	if (refilling.CompareExchange(expected, true))
+	{
+		refillTask = Async(EAsyncExecution::TaskGraph, [this]()
+		{
+			// A Pop or SetHorizon that lands while Refill is finishing sees refilling set and leaves it to
+			// this task, so check again once it is cleared and carry on if nobody else has taken over
+			do
+			{
+				Refill();
+				refilling = false;
+			}
+			while (Num() < horizon.Load() && !refilling.Exchange(true));
+		});
+	}
+}
+
+void FTrackPlanner::Refill()
+{
+	while ((int)(tail.Load() - head.Load()) < horizon.Load())
+	{
+		FPlannedTile& planned = entries[tail.Load() % CAPACITY];
+
+		planned.tileType = generator.NextTileType(previousTile);
+		planned.leftVariant = planned.tileType == ETileType::eCliff && generator.ChooseLeftVariant();
+		planned.cornerLeft = generator.ChooseLeftVariant();
+		planned.trackDistance = plannedDistance;
+
+		generator.RecordSpawnedTile(planned.tileType);
+		previousTile = planned.tileType;
+		plannedDistance += tileLength;
+
+		// Publish only once the entry is complete
+		tail = tail.Load() + 1;
+	}
+}
@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Templates/Atomic.h"
+#include "TrackGenerator.h"
+#include "TrackPlanner.generated.h"
+
+USTRUCT(BlueprintType)
+struct FPlannedTile
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = Tile)
+		ETileType tileType = ETileType::eBasic;
+
+	// Left or right cliff module
+	UPROPERTY(BlueprintReadOnly, Category = Tile)
+		bool leftVariant = false;
+
+	// Side used if the level asks for a corner just before this tile
+	UPROPERTY(BlueprintReadOnly, Category = Tile)
+		bool cornerLeft = false;
+
+	// Distance along the track from the start of the run
+	UPROPERTY(BlueprintReadOnly, Category = Tile)
+		float trackDistance = 0.0f;
+
+	// Filled in when read through the Game Mode, from the next tile transform
+	UPROPERTY(BlueprintReadOnly, Category = Tile)
+		FTransform worldTransform;
+	UPROPERTY(BlueprintReadOnly, Category = Tile)
+		FRotator cornerRotation = { 0.0f, 0.0f, 0.0f };
+};
+
+/**
+ * Ring buffer of the next tiles, refilled by a task graph worker.
+ * Single producer (the refill task) and single consumer (the game thread).
+ */
+class BETAARCADE_API FTrackPlanner
+{
+public:
+
+	static const int CAPACITY = 64;
+
+	~FTrackPlanner();
+
+	// Takes a copy of the generator, it is only touched by the refill task from here on
+	void Start(const FTrackGenerator& generator, float tileLength);
+	void Stop();
+	bool IsRunning() const { return running; }
+
+	// How many tiles to keep planned, clamped to the buffer size
+	void SetHorizon(int tiles);
+	int GetHorizon() const { return horizon.Load(); }
+
+	// Takes the next planned tile, waits for the worker if the plan has run dry
+	bool Pop(FPlannedTile& outTile);
+
+	// Copies up to maxTiles upcoming tiles without consuming them
+	int Peek(TArray<FPlannedTile>& outTiles, int maxTiles) const;
+	bool PeekNext(FPlannedTile& outTile) const;
+	int Num() const { return (int)(tail.Load() - head.Load()); }
+
+	int GetUnderflows() const { return underflows; }
+
+	// Stats of the planner's own generator, which makes every roll once the planner is running.
+	// Game thread only, waits for a refill in flight so the copy is consistent
+	FTrackGeneratorStats GetGeneratorStats() const;
+
+private:
+
+	void RequestRefill();
+	void Refill();
+
+	FPlannedTile entries[CAPACITY];
+	TAtomic<uint32> head{ 0 }; // Next entry to read, only written by the game thread
+	TAtomic<uint32> tail{ 0 }; // Next entry to write, only written by the refill task
+	TAtomic<bool> refilling{ false };
+	TFuture<void> refillTask;
+
+	// Owned by the refill task while one is in flight
+	FTrackGenerator generator;
+	ETileType previousTile = ETileType::eBasic;
+	float plannedDistance = 0.0f;
+	float tileLength = 1000.0f;
+
+	TAtomic<int> horizon{ 8 }; // Set by the game thread, read by the refill task
+	int underflows = 0;
+	bool running = false;
+};
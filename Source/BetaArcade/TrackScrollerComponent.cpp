@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrackScrollerComponent.h"
+#include "BetaArcade.h"
+#include "BetaArcadeTrace.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/SceneComponent.h"
+#include "GameFramework/Actor.h"
+
+DECLARE_CYCLE_STAT(TEXT("Track Scroll"), STAT_TrackScroll, STATGROUP_BetaArcade);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scrolled Actors"), STAT_ScrolledActors, STATGROUP_BetaArcade);
+
+UTrackScrollerComponent::UTrackScrollerComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickGroup = TG_PrePhysics; // Move the track before the player and physics look at it
+	bAutoActivate = false;
+}
+
+void UTrackScrollerComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_TrackScroll);
+	BETAARCADE_ALLOCATION_SCOPE("TrackScroll");
+
+	const FVector delta = scrollVelocity * DeltaTime;
+	scrolledDistance += delta.Size();
+	scrolledOffset += delta;
+
+	// No sweeps and a teleport. Each move is deferred in a scoped update, so the children's transforms and the
+	// overlaps of tiles that keep them are worked out once when the scope closes rather than during the move
+	for (int i = segments.Num() - 1; i >= 0; --i)
+	{
+		FScrollSegment& segment = segments[i];
+		if (!segment.root || !segment.actor || segment.actor->IsPendingKill())
+		{
+			segments.RemoveAtSwap(i, 1, false);
+			continue;
+		}
+
+		FScopedMovementUpdate scopedMove(segment.root, EScopedUpdate::DeferredUpdates);
+		segment.root->SetWorldLocation(segment.root->GetComponentLocation() + delta, false, nullptr, ETeleportType::TeleportPhysics);
+	}
+
+	SET_DWORD_STAT(STAT_ScrolledActors, segments.Num());
+}
+
+void UTrackScrollerComponent::AddSegment(AActor* actor, bool skipOverlaps)
+{
+	if (!actor || !actor->GetRootComponent())
+	{
+		return;
+	}
+
+	if (skipOverlaps)
+	{
+		TInlineComponentArray<UPrimitiveComponent*> primitives(actor);
+		for (UPrimitiveComponent* primitive : primitives)
+		{
+			primitive->SetGenerateOverlapEvents(false);
+		}
+	}
+
+	FScrollSegment segment;
+	segment.actor = actor;
+	segment.root = actor->GetRootComponent();
+	segments.Add(segment);
+}
+
+void UTrackScrollerComponent::RemoveSegment(AActor* actor)
+{
+	const int index = segments.IndexOfByPredicate([actor](const FScrollSegment& segment) { return segment.actor == actor; });
+	if (index != INDEX_NONE)
+	{
+		segments.RemoveAtSwap(index, 1, false);
+	}
+}
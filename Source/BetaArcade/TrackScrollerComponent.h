@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "TrackScrollerComponent.generated.h"
+
+USTRUCT()
+struct FScrollSegment
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		AActor* actor = nullptr;
+	UPROPERTY()
+		USceneComponent* root = nullptr;
+};
+
+/**
+ * Moves every live tile, island and pickup towards the player in one loop, instead of each
+ * Blueprint moving itself. The Game Mode registers actors as they are spawned and removes them when recycled.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class BETAARCADE_API UTrackScrollerComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UTrackScrollerComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// skipOverlaps turns overlap events off on the actor, for decoration that nothing needs to touch
+	UFUNCTION(BlueprintCallable)
+		void AddSegment(AActor* actor, bool skipOverlaps);
+
+	UFUNCTION(BlueprintCallable)
+		void RemoveSegment(AActor* actor);
+
+	UFUNCTION(BlueprintCallable)
+		int GetNumSegments() const { return segments.Num(); }
+
+	// World units per second, usually mapDirection * mapSpeed
+	UPROPERTY(BlueprintReadWrite, Category = Speed)
+		FVector scrollVelocity = { 0.0f, 0.0f, 0.0f };
+
+	// Total distance moved since BeginPlay, used as the player's position along the track
+	UPROPERTY(BlueprintReadOnly, Category = Speed)
+		float scrolledDistance = 0.0f;
+
+	// Total movement since BeginPlay, lets a position taken earlier be corrected for the scrolling since
+	UPROPERTY(BlueprintReadOnly, Category = Speed)
+		FVector scrolledOffset = { 0.0f, 0.0f, 0.0f };
+
+private:
+
+	UPROPERTY()
+		TArray<FScrollSegment> segments;
+};
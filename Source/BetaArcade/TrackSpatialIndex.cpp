@@ -0,0 +1,272 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TrackSpatialIndex.h"
+#include "BetaArcade.h"
+#include "BetaArcadeBenchmark.h"
+#include "BetaArcadeTrace.h"
+#include "Components/BoxComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+DECLARE_CYCLE_STAT(TEXT("Track Index Query"), STAT_TrackIndexQuery, STATGROUP_BetaArcade);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Track Index Entries"), STAT_TrackIndexEntries, STATGROUP_BetaArcade);
+
+void UTrackSpatialIndex::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	buckets.SetNum(NUM_BUCKETS);
+}
+
+void UTrackSpatialIndex::Deinitialize()
+{
+	buckets.Empty();
+	entryBuckets.Empty();
+
+	Super::Deinitialize();
+}
+
+void UTrackSpatialIndex::Add(AActor* actor, float distance, int lane, ETrackEntryKind kind, ETileType tileType)
+{
+	const FObjectKey actorKey(actor);
+	if (!actor || entryBuckets.Contains(actorKey))
+	{
+		return;
+	}
+
+	if (buckets.Num() == 0)
+	{
+		buckets.SetNum(NUM_BUCKETS);
+	}
+
+	const int32 bucketNumber = GetBucketNumber(distance);
+	FTrackBucket& bucket = buckets[bucketNumber & (NUM_BUCKETS - 1)];
+	if (bucket.bucketNumber != bucketNumber)
+	{
+		// Left over from a lap of the ring ago, anything still in it has long been passed
+		for (const FTrackEntry& stale : bucket.entries)
+		{
+			entryBuckets.Remove(stale.actorKey);
+		}
+		bucket.entries.Reset();
+		bucket.bucketNumber = bucketNumber;
+	}
+
+	FTrackEntry entry;
+	entry.actor = actor;
+	entry.distance = distance;
+	entry.lane = lane;
+	entry.kind = kind;
+	entry.tileType = tileType;
+	entry.actorKey = actorKey;
+	bucket.entries.Add(entry);
+	entryBuckets.Add(actorKey, bucketNumber);
+
+	SET_DWORD_STAT(STAT_TrackIndexEntries, entryBuckets.Num());
+}
+
+void UTrackSpatialIndex::Remove(AActor* actor)
+{
+	const FObjectKey actorKey(actor);
+	int32 bucketNumber;
+	if (!entryBuckets.RemoveAndCopyValue(actorKey, bucketNumber))
+	{
+		return;
+	}
+
+	FTrackBucket& bucket = buckets[bucketNumber & (NUM_BUCKETS - 1)];
+	const int index = bucket.entries.IndexOfByPredicate([&actorKey](const FTrackEntry& entry) { return entry.actorKey == actorKey; });
+	if (index != INDEX_NONE)
+	{
+		bucket.entries.RemoveAtSwap(index, 1, false);
+	}
+
+	SET_DWORD_STAT(STAT_TrackIndexEntries, entryBuckets.Num());
+}
+
+const FTrackBucket* UTrackSpatialIndex::FindBucket(int32 bucketNumber) const
+{
+	if (buckets.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	const FTrackBucket& bucket = buckets[bucketNumber & (NUM_BUCKETS - 1)];
+	return bucket.bucketNumber == bucketNumber ? &bucket : nullptr;
+}
+
+void UTrackSpatialIndex::Query(float minDistance, float maxDistance, int lane, int32 kindMask, TArray<FTrackEntry>& outEntries) const
+{
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_TrackIndexQuery);
+	BETAARCADE_ALLOCATION_SCOPE("TrackIndex");
+
+	const int32 firstBucket = GetBucketNumber(minDistance);
+	const int32 lastBucket = FMath::Min(GetBucketNumber(maxDistance), firstBucket + NUM_BUCKETS - 1);
+
+	for (int32 bucketNumber = firstBucket; bucketNumber <= lastBucket; ++bucketNumber)
+	{
+		const FTrackBucket* bucket = FindBucket(bucketNumber);
+		if (!bucket)
+		{
+			continue;
+		}
+
+		for (const FTrackEntry& entry : bucket->entries)
+		{
+			if (entry.actor && entry.distance >= minDistance && entry.distance <= maxDistance
+				&& (lane == TRACK_LANE_ANY || entry.lane == lane)
+				&& (kindMask & (1 << (int32)entry.kind)))
+			{
+				outEntries.Add(entry);
+			}
+		}
+	}
+}
+
+bool UTrackSpatialIndex::FindNext(float fromDistance, float maxAhead, int lane, int32 kindMask, FTrackEntry& outEntry) const
+{
+	BETAARCADE_SCOPE_CYCLE_COUNTER(STAT_TrackIndexQuery);
+	BETAARCADE_ALLOCATION_SCOPE("TrackIndex");
+
+	const float maxDistance = fromDistance + maxAhead;
+	const int32 firstBucket = GetBucketNumber(fromDistance);
+	const int32 lastBucket = FMath::Min(GetBucketNumber(maxDistance), firstBucket + NUM_BUCKETS - 1);
+
+	for (int32 bucketNumber = firstBucket; bucketNumber <= lastBucket; ++bucketNumber)
+	{
+		const FTrackBucket* bucket = FindBucket(bucketNumber);
+		if (!bucket)
+		{
+			continue;
+		}
+
+		// Entries in a bucket aren't sorted, but buckets are, so the first bucket with a hit has the nearest
+		const FTrackEntry* nearest = nullptr;
+		for (const FTrackEntry& entry : bucket->entries)
+		{
+			if (entry.actor && entry.distance >= fromDistance && entry.distance <= maxDistance
+				&& (lane == TRACK_LANE_ANY || entry.lane == lane)
+				&& (kindMask & (1 << (int32)entry.kind))
+				&& (!nearest || entry.distance < nearest->distance))
+			{
+				nearest = &entry;
+			}
+		}
+
+		if (nearest)
+		{
+			outEntry = *nearest;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+TArray<FTrackEntry> UTrackSpatialIndex::QueryAroundPlayer(float behind, float ahead, int lane, ETrackEntryKind kind)
+{
+	TArray<FTrackEntry> entries;
+	Query(playerDistance - behind, playerDistance + ahead, lane, 1 << (int32)kind, entries);
+	return entries;
+}
+
+int UTrackSpatialIndex::GetLane(float lateralOffset, float laneWidth)
+{
+	return FMath::Clamp(FMath::RoundToInt(lateralOffset / FMath::Max(laneWidth, 1.0f)), -1, 1);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs SpatialIndexBenchmarkCommand(
+	TEXT("BetaArcade.SpatialIndexBenchmark"),
+	TEXT("BetaArcade.SpatialIndexBenchmark [entries=2000] [queries=20000] - times track index queries against box overlaps, appends to Saved/Benchmarks/SpatialIndex.csv"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& args, UWorld* world)
+	{
+		int numEntries = FMath::Max(args.Num() > 0 ? FCString::Atoi(*args[0]) : 2000, 1);
+		const int numQueries = FMath::Max(args.Num() > 1 ? FCString::Atoi(*args[1]) : 20000, 1);
+
+		// About four obstacles and pickups per 1000 unit tile, spread over three lanes
+		const float spacing = 250.0f;
+		const float laneWidth = TRACK_LANE_WIDTH;
+		const FVector origin(0.0f, 0.0f, -50000.0f);
+
+		// A standalone index, so the benchmark doesn't disturb the one the game is using
+		UTrackSpatialIndex* index = NewObject<UTrackSpatialIndex>();
+		const int maxEntries = FMath::FloorToInt(index->GetIndexedLength() / spacing);
+		if (numEntries > maxEntries)
+		{
+			UE_LOG(LogBetaArcade, Warning, TEXT("SpatialIndexBenchmark is limited to %d entries"), maxEntries);
+			numEntries = maxEntries;
+		}
+
+		FActorSpawnParameters spawnParams;
+		spawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		TArray<AActor*> actors;
+		FRandomStream stream(1234);
+		for (int i = 0; i < numEntries; ++i)
+		{
+			const int lane = stream.RandRange(-1, 1);
+			const FVector location = origin + FVector(i * spacing, lane * laneWidth, 0.0f);
+
+			AActor* actor = world->SpawnActor<AActor>(AActor::StaticClass(), location, FRotator::ZeroRotator, spawnParams);
+			UBoxComponent* box = NewObject<UBoxComponent>(actor);
+			box->SetBoxExtent(FVector(50.0f));
+			box->SetCollisionProfileName(TEXT("OverlapAllDynamic"));
+			actor->SetRootComponent(box);
+			box->RegisterComponent();
+			box->SetWorldLocation(location);
+
+			actors.Add(actor);
+			index->Add(actor, i * spacing, lane, (ETrackEntryKind)(i % 3));
+		}
+
+		// Same question both ways: what is in my lane in the next 2000 units
+		const float lookahead = 2000.0f;
+		const float trackLength = numEntries * spacing;
+		TArray<float> queryDistances;
+		TArray<int> queryLanes;
+		for (int i = 0; i < numQueries; ++i)
+		{
+			queryDistances.Add(stream.FRandRange(0.0f, trackLength));
+			queryLanes.Add(stream.RandRange(-1, 1));
+		}
+
+		int64 indexHits = 0;
+		TArray<FTrackEntry> entries;
+		double startTime = FPlatformTime::Seconds();
+		for (int i = 0; i < numQueries; ++i)
+		{
+			entries.Reset();
+			index->Query(queryDistances[i], queryDistances[i] + lookahead, queryLanes[i], TRACK_KIND_ALL, entries);
+			indexHits += entries.Num();
+		}
+		const double indexSeconds = FPlatformTime::Seconds() - startTime;
+
+		int64 overlapHits = 0;
+		TArray<FOverlapResult> overlaps;
+		const FCollisionShape shape = FCollisionShape::MakeBox(FVector(lookahead * 0.5f, laneWidth * 0.5f, 100.0f));
+		const FCollisionObjectQueryParams objectParams(FCollisionObjectQueryParams::AllDynamicObjects);
+		startTime = FPlatformTime::Seconds();
+		for (int i = 0; i < numQueries; ++i)
+		{
+			overlaps.Reset();
+			const FVector centre = origin + FVector(queryDistances[i] + lookahead * 0.5f, queryLanes[i] * laneWidth, 0.0f);
+			world->OverlapMultiByObjectType(overlaps, centre, FQuat::Identity, objectParams, shape);
+			overlapHits += overlaps.Num();
+		}
+		const double overlapSeconds = FPlatformTime::Seconds() - startTime;
+
+		for (AActor* actor : actors)
+		{
+			actor->Destroy();
+		}
+
+		const double indexUs = indexSeconds * 1000000.0 / numQueries;
+		const double overlapUs = overlapSeconds * 1000000.0 / numQueries;
+		UE_LOG(LogBetaArcade, Display, TEXT("SpatialIndexBenchmark entries=%d queries=%d index=%.3fus overlap=%.3fus hits=%lld/%lld"),
+			numEntries, numQueries, indexUs, overlapUs, indexHits, overlapHits);
+
+		AppendBenchmarkCsv(TEXT("SpatialIndex.csv"), TEXT("entries,queries,indexUs,overlapUs,indexHits,overlapHits"),
+			FString::Printf(TEXT("%d,%d,%.4f,%.4f,%lld,%lld\n"), numEntries, numQueries, indexUs, overlapUs, indexHits, overlapHits));
+	}));
@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "TrackGenerator.h"
+#include "TrackSpatialIndex.generated.h"
+
+UENUM(BlueprintType)
+enum class ETrackEntryKind : uint8
+{
+	eTile,
+	eObstacle,
+	ePickUp,
+};
+
+static const int32 TRACK_KIND_ALL = 0xFF;
+static const int32 TRACK_LANE_ANY = MIN_int32;
+
+// Lane running clamps the player to one lane width either side of the middle
+static const float TRACK_LANE_WIDTH = 240.0f;
+
+USTRUCT(BlueprintType)
+struct FTrackEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = Track)
+		AActor* actor = nullptr;
+
+	// Distance along the track from where the run started
+	UPROPERTY(BlueprintReadOnly, Category = Track)
+		float distance = 0.0f;
+
+	// -1 left, 0 middle, 1 right
+	UPROPERTY(BlueprintReadOnly, Category = Track)
+		int lane = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = Track)
+		ETrackEntryKind kind = ETrackEntryKind::eTile;
+
+	// Tile the entry is on, for obstacles and pickups the tile they came with
+	UPROPERTY(BlueprintReadOnly, Category = Track)
+		ETileType tileType = ETileType::eBasic;
+
+	// Still identifies the entry after actor has been nulled by a Destroy
+	FObjectKey actorKey;
+};
+
+USTRUCT()
+struct FTrackBucket
+{
+	GENERATED_BODY()
+
+	int32 bucketNumber = INDEX_NONE;
+
+	UPROPERTY()
+		TArray<FTrackEntry> entries;
+};
+
+/**
+ * Tiles, obstacles and pickups bucketed by distance along the track, so "what is near the player" or
+ * "what is coming up in this lane" only looks at a few buckets rather than asking physics.
+ * Buckets are a fixed ring, the track only moves forwards so old buckets are reused as the run goes on.
+ */
+UCLASS()
+class BETAARCADE_API UTrackSpatialIndex : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	UFUNCTION(BlueprintCallable)
+		void Add(AActor* actor, float distance, int lane, ETrackEntryKind kind, ETileType tileType = ETileType::eBasic);
+	UFUNCTION(BlueprintCallable)
+		void Remove(AActor* actor);
+
+	// Everything between minDistance and maxDistance, kindMask is a bitmask of (1 << ETrackEntryKind)
+	void Query(float minDistance, float maxDistance, int lane, int32 kindMask, TArray<FTrackEntry>& outEntries) const;
+
+	// Nearest entry at or past fromDistance, returns false if nothing is within maxAhead
+	bool FindNext(float fromDistance, float maxAhead, int lane, int32 kindMask, FTrackEntry& outEntry) const;
+
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Query Track"))
+		TArray<FTrackEntry> QueryAroundPlayer(float behind, float ahead, int lane, ETrackEntryKind kind);
+
+	// The game mode keeps this up to date, queries around the player are relative to it
+	void SetPlayerDistance(float distance) { playerDistance = distance; }
+	UFUNCTION(BlueprintCallable)
+		float GetPlayerDistance() const { return playerDistance; }
+
+	UFUNCTION(BlueprintCallable)
+		int GetNumEntries() const { return entryBuckets.Num(); }
+
+	// Lane of a sideways offset from the middle of the track
+	static int GetLane(float lateralOffset, float laneWidth = TRACK_LANE_WIDTH);
+
+	float bucketLength = 500.0f;
+
+	// How far the ring reaches before buckets are reused
+	float GetIndexedLength() const { return NUM_BUCKETS * bucketLength; }
+
+private:
+
+	// 5km of track at the default bucket length, far more than is ever alive at once
+	static const int NUM_BUCKETS = 1024;
+
+	int32 GetBucketNumber(float distance) const { return FMath::FloorToInt(distance / bucketLength); }
+	const FTrackBucket* FindBucket(int32 bucketNumber) const;
+
+	// Referenced so destroyed actors are nulled rather than left dangling
+	UPROPERTY()
+		TArray<FTrackBucket> buckets;
+
+	// Which bucket each actor went into, for Remove. Keyed by FObjectKey so an actor destroyed without
+	// Remove can't stop a new one at the same address going in, its entry goes when the bucket is reused
+	TMap<FObjectKey, int32> entryBuckets;
+
+	float playerDistance = 0.0f;
+};
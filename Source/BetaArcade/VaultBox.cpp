@@ -15,7 +15,15 @@ AVaultBox::AVaultBox()
 void AVaultBox::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	URunnerTickManager::RegisterActor(this, ERunnerTickCategory::eVaultBox);
+}
+
+void AVaultBox::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	URunnerTickManager::UnregisterActor(this, ERunnerTickCategory::eVaultBox);
+
+	Super::EndPlay(EndPlayReason);
 }
 
 // Called every frame